@@ -0,0 +1,543 @@
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// --- 大量の数値入力を速く読む NumberReader ---
+// lesson3_2 の cin >> は、1つ読むたびにロケールを確かめ、失敗すると cin 全体が fail 状態になる（lesson3_4）。
+// 数 MB のコマンドやリプレイのデータを読むには遅すぎる。
+//
+// NumberReader はファイル（または stdin）を 1MB ずつまとめて読み込み、
+//   - 区切り文字（空白・タブ・改行・カンマ）を SIMD で 16 / 32 バイトずつ探し
+//   - 8桁以内の整数は 8 バイトをまとめて変換し、それ以外は std::from_chars を使う（ロケールを見ない）
+// 失敗しても読み込みは止まらず、その項目だけが「何行目の何番目が、なぜだめだったか」を返す
+//
+//   NumberReader reader(stdin);
+//   while (auto field = reader.next<int>()) { ... }
+
+enum class ParseError
+{
+    None,
+    Invalid,     // 数値ではない（"abc"、"12x" など）
+    OutOfRange,  // 型に入りきらない
+    EndOfInput,
+};
+
+const char* to_string(ParseError e)
+{
+    switch (e)
+    {
+    case ParseError::None:       return "OK";
+    case ParseError::Invalid:    return "数値ではありません";
+    case ParseError::OutOfRange: return "範囲外です";
+    case ParseError::EndOfInput: return "入力の終わり";
+    }
+    return "?";
+}
+
+// 1つの項目を読んだ結果
+template<typename T>
+struct Field
+{
+    T                value{};
+    ParseError       error = ParseError::None;
+    std::size_t      line = 0;   // 1 から数える
+    std::size_t      column = 0; // 行の中で何番目の項目か（1 から）
+    std::string_view text;       // 次に読むまで有効
+
+    explicit operator bool() const { return error != ParseError::EndOfInput; }
+    bool ok() const { return error == ParseError::None; }
+};
+
+// エラーになった項目の記録（read_all 用）
+struct FieldError
+{
+    ParseError  error;
+    std::size_t line;
+    std::size_t column;
+    std::string text;
+};
+
+namespace scan
+{
+    // 区切り文字：' ' 以下の制御文字と空白、そしてカンマ
+    inline bool is_delim(char c)
+    {
+        return static_cast<unsigned char>(c) <= ' ' || c == ',';
+    }
+
+#if defined(__AVX2__)
+    constexpr std::size_t WIDTH = 32;
+
+    // p から WIDTH バイトのうち、区切り文字の位置と改行の位置をビットで返す
+    inline void masks(const char* p, std::uint32_t& delim, std::uint32_t& newline)
+    {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const __m256i space = _mm256_set1_epi8(' ');
+        const __m256i ctrl = _mm256_cmpeq_epi8(_mm256_max_epu8(v, space), space); // v <= ' '
+        const __m256i comma = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(','));
+        delim = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(ctrl, comma)));
+        newline = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'))));
+    }
+#elif defined(__SSE2__)
+    constexpr std::size_t WIDTH = 16;
+
+    inline void masks(const char* p, std::uint32_t& delim, std::uint32_t& newline)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i space = _mm_set1_epi8(' ');
+        const __m128i ctrl = _mm_cmpeq_epi8(_mm_max_epu8(v, space), space);
+        const __m128i comma = _mm_cmpeq_epi8(v, _mm_set1_epi8(','));
+        delim = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_or_si128(ctrl, comma)));
+        newline = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))));
+    }
+#else
+    constexpr std::size_t WIDTH = 8;
+
+    inline void masks(const char* p, std::uint32_t& delim, std::uint32_t& newline)
+    {
+        delim = newline = 0;
+        for (std::size_t i = 0; i < WIDTH; ++i)
+        {
+            delim |= static_cast<std::uint32_t>(is_delim(p[i])) << i;
+            newline |= static_cast<std::uint32_t>(p[i] == '\n') << i;
+        }
+    }
+#endif
+
+    constexpr std::uint32_t ALL = WIDTH == 32 ? 0xFFFFFFFFu : (1u << WIDTH) - 1;
+
+    // 64 バイト分のビットマスクをまとめて作る（read_all 用）
+    inline void masks64(const char* p, std::uint64_t& delim, std::uint64_t& newline)
+    {
+        delim = newline = 0;
+        for (std::size_t k = 0; k < 64 / WIDTH; ++k)
+        {
+            std::uint32_t d, n;
+            masks(p + k * WIDTH, d, n);
+            delim |= static_cast<std::uint64_t>(d) << (k * WIDTH);
+            newline |= static_cast<std::uint64_t>(n) << (k * WIDTH);
+        }
+    }
+
+    // 区切り文字を飛ばし、最初の区切り文字でない位置を返す。飛ばした改行の数を lines に足す
+    // end の先 WIDTH バイトまでは読めること
+    inline const char* skip_delims(const char* p, const char* end, std::size_t& lines)
+    {
+        while (p < end)
+        {
+            std::uint32_t delim, newline;
+            masks(p, delim, newline);
+            const std::size_t remain = static_cast<std::size_t>(end - p);
+            const std::uint32_t valid = remain >= WIDTH ? ALL : (1u << remain) - 1;
+            const std::uint32_t token = ~delim & valid;
+            if (token != 0)
+            {
+                const int n = std::countr_zero(token);
+                lines += std::popcount(newline & ((1u << n) - 1));
+                return p + n;
+            }
+            lines += std::popcount(newline & valid);
+            p += WIDTH;
+        }
+        return end;
+    }
+
+    // 最初の区切り文字の位置を返す（なければ end）
+    inline const char* find_delim(const char* p, const char* end)
+    {
+        while (p < end)
+        {
+            std::uint32_t delim, newline;
+            masks(p, delim, newline);
+            if (delim != 0)
+            {
+                const char* found = p + std::countr_zero(delim);
+                return found < end ? found : end;
+            }
+            p += WIDTH;
+        }
+        return end;
+    }
+}
+
+// 8桁までの10進数を、8バイトをまとめた1つの整数として変換する（SWAR）
+// p の先から 8 バイトは読めること。数字以外が含まれていれば false
+inline bool parse_up_to_8_digits(const char* p, std::size_t len, std::uint32_t& out)
+{
+    std::uint64_t chunk;
+    std::memcpy(&chunk, p, sizeof(chunk));
+    const std::uint64_t mask = len == 8 ? ~std::uint64_t{ 0 } : (std::uint64_t{ 1 } << (len * 8)) - 1;
+    // 各バイトが '0'(0x30)〜'9'(0x39) かどうかをまとめて調べる
+    const bool digits = ((chunk & 0xF0F0F0F0F0F0F0F0) & mask) == (0x3030303030303030 & mask)
+                     && (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) & mask) == (0x3030303030303030 & mask);
+    if (!digits)
+    {
+        return false;
+    }
+    // 先頭の文字が下位バイトに入っているので、左に寄せて足りない桁を 0 にする
+    chunk = (chunk & mask) << ((8 - len) * 8);
+    // 隣り合う桁を 2桁 → 4桁 → 8桁 とまとめていく
+    chunk = ((chunk & 0x0F0F0F0F0F0F0F0F) * 2561) >> 8;
+    chunk = ((chunk & 0x00FF00FF00FF00FF) * 6553601) >> 16;
+    out = static_cast<std::uint32_t>(((chunk & 0x0000FFFF0000FFFF) * 42949672960001) >> 32);
+    return true;
+}
+
+class NumberReader
+{
+public:
+    static constexpr std::size_t CHUNK = 1 << 20;
+
+    // stdin など、すでに開いているファイルから読む（閉じるのは呼び出し側）
+    explicit NumberReader(std::FILE* file) : file_(file)
+    {
+        buffer_.resize(CHUNK + PADDING);
+        pos_ = end_ = buffer_.data();
+    }
+
+    explicit NumberReader(const std::string& path) : NumberReader(std::fopen(path.c_str(), "rb"))
+    {
+        if (file_ == nullptr)
+        {
+            throw std::runtime_error("ファイルを開けませんでした: " + path);
+        }
+        owns_file_ = true;
+    }
+
+    ~NumberReader()
+    {
+        if (owns_file_)
+        {
+            std::fclose(file_);
+        }
+    }
+
+    NumberReader(const NumberReader&) = delete;
+    NumberReader& operator=(const NumberReader&) = delete;
+
+    // 次の項目を T として読む。失敗してもその項目を飛ばして次に進む
+    template<typename T>
+    Field<T> next()
+    {
+        Field<T> field;
+        const std::string_view token = next_token();
+        field.line = line_ + 1;
+        field.column = column_;
+        field.text = token;
+        field.error = token.empty() ? ParseError::EndOfInput
+                                    : parse_value(token.data(), token.data() + token.size(), field.value);
+        return field;
+    }
+
+    // 最後まで読み、成功した値と失敗した項目をそれぞれ返す
+    // next() を繰り返すのと同じ結果になるが、64 バイトごとに区切り文字のビットマスクを1回だけ作り、
+    // そのビットをたどって項目の始まりと終わりを見つける
+    template<typename T>
+    std::size_t read_all(std::vector<T>& values, std::vector<FieldError>& errors)
+    {
+        std::size_t count = 0;
+        auto emit = [&](const char* first, const char* last)
+            {
+                T value;
+                const ParseError error = parse_value(first, last, value);
+                if (error == ParseError::None)
+                {
+                    values.push_back(value);
+                    ++count;
+                }
+                else
+                {
+                    errors.push_back({ error, line_ + 1, column_, std::string(first, last) });
+                }
+            };
+
+        const char* token = nullptr; // 読みかけの項目の先頭
+        for (;;)
+        {
+            bool prev_delim = true;  // 直前のバイトが区切り文字だったか
+            for (const char* p = pos_; p < end_; p += 64)
+            {
+                std::uint64_t delim, newline;
+                scan::masks64(p, delim, newline);
+                const auto remain = static_cast<std::size_t>(end_ - p);
+                const std::uint64_t valid = remain >= 64 ? ~std::uint64_t{ 0 } : (std::uint64_t{ 1 } << remain) - 1;
+                const std::uint64_t before = (delim << 1) | (prev_delim ? 1 : 0);
+                const std::uint64_t starts = ~delim & before & valid;  // 区切り文字の直後の文字
+                const std::uint64_t ends = delim & ~before & valid;    // 文字の直後の区切り文字
+                newline &= valid;
+                for (std::uint64_t events = starts | ends | newline; events != 0; events &= events - 1)
+                {
+                    const int i = std::countr_zero(events);
+                    const std::uint64_t bit = std::uint64_t{ 1 } << i;
+                    if (ends & bit)
+                    {
+                        emit(token, p + i);
+                        token = nullptr;
+                    }
+                    if (newline & bit)
+                    {
+                        ++line_;
+                        column_ = 0;
+                    }
+                    if (starts & bit)
+                    {
+                        token = p + i;
+                        ++column_;
+                    }
+                }
+                prev_delim = (delim >> 63) != 0;
+            }
+
+            if (token != nullptr && eof_)
+            {
+                emit(token, end_); // 区切り文字のないまま終わった最後の項目
+                token = nullptr;
+            }
+            if (token != nullptr)
+            {
+                // 読みかけの項目を先頭に残して読み足し、その項目から数え直す
+                pos_ = token;
+                --column_;
+                token = nullptr;
+                refill();
+                continue;
+            }
+            pos_ = end_;
+            if (eof_ || !refill())
+            {
+                return count;
+            }
+        }
+    }
+
+private:
+    static constexpr std::size_t PADDING = 64; // SIMD で end_ の先まで読んでもよい大きさ
+
+    template<typename T>
+    static ParseError parse_value(const char* first, const char* last, T& value)
+    {
+        if (*first == '+' && last - first > 1) // from_chars は先頭の + を受け付けない
+        {
+            ++first;
+            if (*first == '-') // "+-5" のように符号が2つ続くものは数値ではない
+            {
+                return ParseError::Invalid;
+            }
+        }
+        if constexpr (std::is_integral_v<T> && sizeof(T) >= 4)
+        {
+            // よくある「符号 + 8桁以内」は SWAR で変換し、それ以外は from_chars に任せる
+            const bool negative = *first == '-';
+            const char* digits = first + (negative ? 1 : 0);
+            const auto len = static_cast<std::size_t>(last - digits);
+            std::uint32_t magnitude;
+            if (len > 0 && len <= 8 && (!negative || std::is_signed_v<T>)
+                && parse_up_to_8_digits(digits, len, magnitude))
+            {
+                value = negative ? static_cast<T>(-static_cast<std::int64_t>(magnitude)) : static_cast<T>(magnitude);
+                return ParseError::None;
+            }
+        }
+        const auto [ptr, ec] = std::from_chars(first, last, value);
+        if (ec == std::errc::result_out_of_range)
+        {
+            return ParseError::OutOfRange;
+        }
+        if (ec != std::errc() || ptr != last)
+        {
+            return ParseError::Invalid;
+        }
+        return ParseError::None;
+    }
+
+    std::string_view next_token()
+    {
+        // 区切り文字を飛ばす
+        for (;;)
+        {
+            const std::size_t before = line_;
+            pos_ = scan::skip_delims(pos_, end_, line_);
+            if (line_ != before)
+            {
+                column_ = 0;
+            }
+            if (pos_ < end_)
+            {
+                break;
+            }
+            if (eof_ || !refill())
+            {
+                return {};
+            }
+        }
+
+        // 項目の終わりを探す。バッファの終わりまで続いていたら読み足す
+        for (;;)
+        {
+            const char* token_end = scan::find_delim(pos_, end_);
+            if (token_end < end_ || eof_)
+            {
+                const std::string_view token(pos_, static_cast<std::size_t>(token_end - pos_));
+                pos_ = token_end;
+                ++column_;
+                return token;
+            }
+            refill();
+        }
+    }
+
+    // 読み残しを先頭に寄せ、後ろに続きを読み込む。何も読めなければ false
+    bool refill()
+    {
+        const std::size_t keep = static_cast<std::size_t>(end_ - pos_);
+        std::size_t capacity = buffer_.size() - PADDING;
+        if (keep > capacity / 2)
+        {
+            // 1つの項目がとても長い：バッファを広げる
+            const std::size_t offset = static_cast<std::size_t>(pos_ - buffer_.data());
+            capacity *= 2;
+            buffer_.resize(capacity + PADDING);
+            pos_ = buffer_.data() + offset;
+            end_ = pos_ + keep;
+        }
+        std::memmove(buffer_.data(), pos_, keep);
+        const std::size_t n = std::fread(buffer_.data() + keep, 1, capacity - keep, file_);
+        pos_ = buffer_.data();
+        end_ = pos_ + keep + n;
+        // SIMD が end_ の先まで読んでも困らないよう、区切り文字で埋めておく
+        std::memset(const_cast<char*>(end_), '\n', PADDING);
+        if (n == 0)
+        {
+            eof_ = true;
+        }
+        return n > 0;
+    }
+
+    std::FILE*        file_;
+    bool              owns_file_ = false;
+    std::vector<char> buffer_;
+    const char*       pos_;
+    const char*       end_;
+    bool              eof_ = false;
+    std::size_t       line_ = 0;
+    std::size_t       column_ = 0;
+};
+
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    // --- 間違いを含む入力：どの項目がなぜだめかがわかる ---
+    {
+        std::ofstream("input_test.txt") << "170 65\n180, abc, 72\n+42 99999999999999999999 12x +-5\n";
+        NumberReader reader("input_test.txt");
+        while (auto field = reader.next<int>())
+        {
+            if (field.ok())
+            {
+                std::cout << field.value << " ";
+            }
+            else
+            {
+                std::cout << "\n  " << field.line << "行目 " << field.column << "番目 \"" << field.text
+                          << "\": " << to_string(field.error) << "\n";
+            }
+        }
+        std::cout << "\n";
+    }
+
+    // --- 速度の比較：約 32MB の整数 / 小数 ---
+    constexpr int COUNT = 4'000'000;
+    std::mt19937 rng(1);
+    {
+        std::ofstream out("ints_test.txt");
+        std::uniform_int_distribution<int> dist(-1'000'000, 1'000'000);
+        for (int i = 0; i < COUNT; ++i)
+        {
+            out << dist(rng) << ((i % 16 == 15) ? '\n' : ' ');
+        }
+    }
+    {
+        std::ofstream out("doubles_test.txt");
+        std::uniform_real_distribution<double> dist(100.0, 200.0);
+        for (int i = 0; i < COUNT; ++i)
+        {
+            out << dist(rng) << ((i % 2 == 1) ? '\n' : ',');
+        }
+    }
+
+    auto bench = [&](const char* label, const std::string& path, auto parse)
+        {
+            std::ifstream probe(path, std::ios::binary | std::ios::ate);
+            const auto bytes = static_cast<double>(probe.tellg());
+            const auto start = Clock::now();
+            const std::size_t n = parse(path);
+            const double sec = std::chrono::duration<double>(Clock::now() - start).count();
+            std::cout << label << n << "個 " << sec * 1000 << "ms (" << bytes / sec / 1e6 << " MB/s)\n";
+        };
+
+    bench("ifstream >> int:    ", "ints_test.txt", [](const std::string& path)
+        {
+            std::ifstream in(path);
+            std::vector<int> values;
+            int v;
+            while (in >> v)
+            {
+                values.push_back(v);
+            }
+            return values.size();
+        });
+    bench("NumberReader<int>:  ", "ints_test.txt", [](const std::string& path)
+        {
+            NumberReader reader(path);
+            std::vector<int> values;
+            std::vector<FieldError> errors;
+            return reader.read_all(values, errors);
+        });
+    bench("ifstream >> double: ", "doubles_test.txt", [](const std::string& path)
+        {
+            std::ifstream in(path);
+            std::vector<double> values;
+            double v;
+            char comma;
+            while (in >> v)
+            {
+                values.push_back(v);
+                in >> std::ws;
+                if (in.peek() == ',')
+                {
+                    in >> comma;
+                }
+            }
+            return values.size();
+        });
+    bench("NumberReader<double>:", "doubles_test.txt", [](const std::string& path)
+        {
+            NumberReader reader(path);
+            std::vector<double> values;
+            std::vector<FieldError> errors;
+            return reader.read_all(values, errors);
+        });
+
+    std::remove("input_test.txt");
+    std::remove("ints_test.txt");
+    std::remove("doubles_test.txt");
+    return 0;
+}
@@ -0,0 +1,335 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+// --- 何百万行の身長・体重から BMI の統計を出すストリーミング処理 ---
+// lesson6_3 の calcBMI は1人分を計算する関数だった。
+// ここでは CSV を少しずつ読み、列ごとの配列（身長の配列・体重の配列）に詰めて、
+// 配列全体を一度に計算する calcBMI に渡す。
+// 平均・ヒストグラム・パーセンタイルも同じ1回の読み込みの中で更新するので、
+// 入力が何 GB あっても使うメモリは一定（読み込みバッファ + 1バッチ分の配列 + ヒストグラム）
+
+// 1人分（lesson6_3 と同じ）
+double calcBMI(double height, double weight)
+{
+    double height_m = height / 100.0;
+    return weight / (height_m * height_m);
+}
+
+// 配列版：heights[i], weights[i] から out[i] を計算する
+void calcBMI(std::span<const double> heights, std::span<const double> weights, std::span<double> out)
+{
+    const std::size_t n = std::min({ heights.size(), weights.size(), out.size() });
+    std::size_t i = 0;
+#if defined(__AVX__)
+    // 4人分ずつ計算する
+    const __m256d scale = _mm256_set1_pd(10000.0); // weight / (h/100)^2 = weight * 10000 / h^2
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m256d h = _mm256_loadu_pd(heights.data() + i);
+        const __m256d w = _mm256_loadu_pd(weights.data() + i);
+        _mm256_storeu_pd(out.data() + i, _mm256_div_pd(_mm256_mul_pd(w, scale), _mm256_mul_pd(h, h)));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        out[i] = weights[i] * 10000.0 / (heights[i] * heights[i]);
+    }
+}
+
+// --- CSV を列ごとのバッチに読み込む ---
+// 1行は「身長(cm),体重(kg)」。読めない行は飛ばして数だけ数える
+class BodyCsvReader
+{
+public:
+    static constexpr std::size_t BATCH = 4096;
+    static constexpr std::size_t CHUNK = 1 << 20;
+
+    explicit BodyCsvReader(const std::string& path) : file_(std::fopen(path.c_str(), "rb"))
+    {
+        if (file_ == nullptr)
+        {
+            throw std::runtime_error("ファイルを開けませんでした: " + path);
+        }
+        buffer_.resize(CHUNK);
+        pos_ = end_ = buffer_.data();
+    }
+
+    ~BodyCsvReader()
+    {
+        std::fclose(file_);
+    }
+
+    BodyCsvReader(const BodyCsvReader&) = delete;
+    BodyCsvReader& operator=(const BodyCsvReader&) = delete;
+
+    // 次のバッチを読み、読めた人数を返す（最後まで読んだら 0）
+    std::size_t next_batch()
+    {
+        count_ = 0;
+        while (count_ < BATCH)
+        {
+            const char* newline = static_cast<const char*>(std::memchr(pos_, '\n', static_cast<std::size_t>(end_ - pos_)));
+            if (newline == nullptr)
+            {
+                if (eof_)
+                {
+                    if (pos_ < end_)
+                    {
+                        parse_line(pos_, end_); // 改行のない最後の行
+                        pos_ = end_;
+                    }
+                    break;
+                }
+                refill();
+                continue;
+            }
+            parse_line(pos_, newline);
+            pos_ = newline + 1;
+        }
+        return count_;
+    }
+
+    std::span<const double> heights() const { return { heights_.data(), count_ }; }
+    std::span<const double> weights() const { return { weights_.data(), count_ }; }
+    std::size_t             skipped_rows() const { return skipped_; }
+
+private:
+    void parse_line(const char* first, const char* last)
+    {
+        if (last > first && last[-1] == '\r')
+        {
+            --last;
+        }
+        double h, w;
+        const auto r1 = std::from_chars(first, last, h);
+        if (r1.ec != std::errc() || r1.ptr == last || *r1.ptr != ',')
+        {
+            ++skipped_; // 見出し行や壊れた行
+            return;
+        }
+        const auto r2 = std::from_chars(r1.ptr + 1, last, w);
+        // from_chars は "nan" や "inf" も読めるので、有限の正の値だけを通す
+        if (r2.ec != std::errc() || r2.ptr != last || !std::isfinite(h) || !std::isfinite(w) || h <= 0.0 || w <= 0.0)
+        {
+            ++skipped_;
+            return;
+        }
+        heights_[count_] = h;
+        weights_[count_] = w;
+        ++count_;
+    }
+
+    void refill()
+    {
+        const std::size_t keep = static_cast<std::size_t>(end_ - pos_);
+        if (keep == buffer_.size())
+        {
+            buffer_.resize(buffer_.size() * 2); // 1行がバッファより長い
+        }
+        std::memmove(buffer_.data(), pos_, keep);
+        const std::size_t n = std::fread(buffer_.data() + keep, 1, buffer_.size() - keep, file_);
+        pos_ = buffer_.data();
+        end_ = pos_ + keep + n;
+        eof_ = n == 0;
+    }
+
+    std::FILE*                    file_;
+    std::vector<char>             buffer_;
+    const char*                   pos_ = nullptr;
+    const char*                   end_ = nullptr;
+    bool                          eof_ = false;
+    std::array<double, BATCH>     heights_;
+    std::array<double, BATCH>     weights_;
+    std::size_t                   count_ = 0;
+    std::size_t                   skipped_ = 0;
+};
+
+// --- 1回の読み込みで更新できる集計 ---
+// パーセンタイルは全件を並べ替えずに、幅 0.1 のヒストグラムから求める（誤差は最大 0.1）
+class BmiStats
+{
+public:
+    static constexpr double MIN_BMI = 10.0;
+    static constexpr double MAX_BMI = 60.0;
+    static constexpr double BIN_WIDTH = 0.1;
+    static constexpr std::size_t BINS = static_cast<std::size_t>((MAX_BMI - MIN_BMI) / BIN_WIDTH);
+
+    void add(std::span<const double> bmi)
+    {
+        for (double v : bmi)
+        {
+            ++count_;
+            sum_ += v;
+            sum_sq_ += v * v;
+            min_ = std::min(min_, v);
+            max_ = std::max(max_, v);
+            // 範囲外は両端の箱に入れる
+            const double pos = std::clamp((v - MIN_BMI) / BIN_WIDTH, 0.0, static_cast<double>(BINS - 1));
+            ++bins_[static_cast<std::size_t>(pos)];
+            ++categories_[category_of(v)];
+        }
+    }
+
+    std::uint64_t count() const { return count_; }
+    double mean() const { return count_ ? sum_ / static_cast<double>(count_) : 0.0; }
+    double stddev() const
+    {
+        const double m = mean();
+        return count_ ? std::sqrt(std::max(0.0, sum_sq_ / static_cast<double>(count_) - m * m)) : 0.0;
+    }
+    double min() const { return min_; }
+    double max() const { return max_; }
+
+    // p = 0〜100。該当する箱の中は一様に分布しているとみなして補間する
+    double percentile(double p) const
+    {
+        const double target = p / 100.0 * static_cast<double>(count_);
+        double seen = 0.0;
+        for (std::size_t b = 0; b < BINS; ++b)
+        {
+            if (seen + static_cast<double>(bins_[b]) >= target && bins_[b] > 0)
+            {
+                const double inside = (target - seen) / static_cast<double>(bins_[b]);
+                return MIN_BMI + (static_cast<double>(b) + inside) * BIN_WIDTH;
+            }
+            seen += static_cast<double>(bins_[b]);
+        }
+        return MAX_BMI;
+    }
+
+    // 日本肥満学会の判定基準
+    static constexpr const char* CATEGORY_NAMES[] = { "低体重", "普通体重", "肥満(1度)", "肥満(2度以上)" };
+
+    std::uint64_t category_count(int c) const { return categories_[c]; }
+
+    void print_histogram(std::ostream& os, double from, double to, double step) const
+    {
+        for (double lo = from; lo < to; lo += step)
+        {
+            std::uint64_t n = 0;
+            for (double x = lo; x < lo + step - 1e-9; x += BIN_WIDTH)
+            {
+                n += bins_[static_cast<std::size_t>((x - MIN_BMI) / BIN_WIDTH + 0.5)];
+            }
+            const auto bar = static_cast<int>(60.0 * static_cast<double>(n) / static_cast<double>(count_));
+            char label[32];
+            std::snprintf(label, sizeof(label), "%4.0f-%-4.0f ", lo, lo + step);
+            os << label << std::string(static_cast<std::size_t>(bar), '#') << " " << n << "\n";
+        }
+    }
+
+private:
+    static int category_of(double bmi)
+    {
+        if (bmi < 18.5) return 0;
+        if (bmi < 25.0) return 1;
+        if (bmi < 30.0) return 2;
+        return 3;
+    }
+
+    std::uint64_t                   count_ = 0;
+    double                          sum_ = 0.0;
+    double                          sum_sq_ = 0.0;
+    double                          min_ = 1e300;
+    double                          max_ = -1e300;
+    std::array<std::uint64_t, BINS> bins_{};
+    std::array<std::uint64_t, 4>    categories_{};
+};
+
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+    const std::string path = "body_test.csv";
+    constexpr int ROWS = 2'000'000;
+
+    // テスト用のデータ（途中に壊れた行も混ぜる）
+    {
+        std::ofstream out(path);
+        std::mt19937 rng(1);
+        std::normal_distribution<double> height(165.0, 9.0);
+        std::normal_distribution<double> bmi(22.5, 3.5);
+        out << "height_cm,weight_kg\n";
+        char line[64];
+        for (int i = 0; i < ROWS; ++i)
+        {
+            const double h = height(rng);
+            const double w = std::max(13.0, bmi(rng)) * (h / 100.0) * (h / 100.0);
+            std::snprintf(line, sizeof(line), "%.1f,%.1f\n", h, w);
+            const int bad = i % 500000;
+            out << (bad == 7 ? "???,60\n" : bad == 8 ? "nan,60\n" : bad == 9 ? "170,inf\n" : line);
+        }
+    }
+
+    // --- ストリーミング：バッチごとに calcBMI → 集計 ---
+    auto start = Clock::now();
+    BodyCsvReader reader(path);
+    BmiStats stats;
+    std::array<double, BodyCsvReader::BATCH> bmi;
+    while (const std::size_t n = reader.next_batch())
+    {
+        calcBMI(reader.heights(), reader.weights(), std::span(bmi.data(), n));
+        stats.add(std::span(bmi.data(), n));
+    }
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+
+    std::cout << "ストリーミング: " << ms << "ms / " << stats.count() << "人 (飛ばした行: "
+              << reader.skipped_rows() << ")\n";
+    std::cout << "使ったメモリ: 約" << (sizeof(BodyCsvReader) + BodyCsvReader::CHUNK + sizeof(bmi) + sizeof(BmiStats)) / 1024
+              << "KB（行数に関係なく一定）\n\n";
+
+    std::cout << "平均 " << stats.mean() << " / 標準偏差 " << stats.stddev()
+              << " / 最小 " << stats.min() << " / 最大 " << stats.max() << "\n";
+    for (double p : { 5.0, 25.0, 50.0, 75.0, 95.0 })
+    {
+        std::cout << "  " << p << "パーセンタイル: " << stats.percentile(p) << "\n";
+    }
+    for (int c = 0; c < 4; ++c)
+    {
+        std::cout << "  " << BmiStats::CATEGORY_NAMES[c] << ": " << stats.category_count(c) << "人\n";
+    }
+    std::cout << "\n";
+    stats.print_histogram(std::cout, 14.0, 36.0, 2.0);
+
+    // --- 比較：全部読み込んでから1人ずつ計算し、並べ替えて中央値を出す ---
+    start = Clock::now();
+    std::ifstream in(path);
+    std::string header;
+    std::getline(in, header);
+    std::vector<double> all;
+    double h, w;
+    char comma;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (std::sscanf(line.c_str(), "%lf%c%lf", &h, &comma, &w) == 3 && std::isfinite(h) && std::isfinite(w))
+        {
+            all.push_back(calcBMI(h, w));
+        }
+    }
+    std::nth_element(all.begin(), all.begin() + all.size() / 2, all.end());
+    ms = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+    std::cout << "\n全件読み込み: " << ms << "ms / 中央値 " << all[all.size() / 2]
+              << " / 使ったメモリ: 約" << all.capacity() * sizeof(double) / 1024 << "KB\n";
+
+    std::remove(path.c_str());
+    return 0;
+}
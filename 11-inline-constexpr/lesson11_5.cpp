@@ -0,0 +1,411 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <span>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// --- 速い三角関数：constexpr の表と多項式近似 ---
+// lesson11_4 の Deg2Rad でラジアンにしたあと、敵ごとに std::sin / std::cos / std::atan2 を呼ぶと、
+// 向きや回転の計算だけでフレームの時間をかなり使ってしまう。
+//
+//   table_sin / table_cos … コンパイル時に作った表を線形補間（最大誤差 約 5e-6, |x| <= 2π）
+//   fast_sin / fast_cos   … π/2 ごとに折り返して 7次の多項式（最大誤差 約 1e-7, |x| < 1000）
+//   fast_atan2            … 7次の多項式（最大誤差 約 3e-7 rad）
+//   span 版               … AVX2 で 8 個ずつまとめて計算する（なければ1個ずつ）
+//
+// 最大誤差は main で std:: の関数と比べて確かめている。
+// 表は角度が大きいほど float の桁が足りなくなり（|x| = 1000 で約 1e-4）、
+// fast_sin / fast_cos も |x| が数万を超えると折り返しの誤差が増える。角度は毎フレーム正規化しておくこと
+
+constexpr float PI = 3.1415926535f;
+constexpr float TWO_PI = 2.0f * PI;
+constexpr float HALF_PI = 0.5f * PI;
+constexpr int MAX_ENEMY = 32;
+
+inline float Deg2Rad(float deg)
+{
+    return deg * PI / 180.0f;
+}
+
+// --- constexpr で作る sin の表 ---
+namespace detail
+{
+    // コンパイル時に使える sin（テイラー展開。表を作るためだけなので速さは気にしない）
+    constexpr double cx_sin(double x)
+    {
+        constexpr double pi = 3.14159265358979323846;
+        while (x > pi)
+        {
+            x -= 2.0 * pi;
+        }
+        while (x < -pi)
+        {
+            x += 2.0 * pi;
+        }
+        double term = x;
+        double sum = x;
+        for (int n = 1; n < 20; ++n)
+        {
+            term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+            sum += term;
+        }
+        return sum;
+    }
+
+    template<std::size_t N>
+    constexpr std::array<float, N + 1> make_sin_table()
+    {
+        std::array<float, N + 1> table{};
+        for (std::size_t i = 0; i <= N; ++i) // 補間用に1つ多く作る
+        {
+            table[i] = static_cast<float>(cx_sin(2.0 * 3.14159265358979323846 * static_cast<double>(i) / N));
+        }
+        return table;
+    }
+}
+
+constexpr std::size_t SIN_TABLE_SIZE = 1024; // 2 のべき乗
+constexpr auto SIN_TABLE = detail::make_sin_table<SIN_TABLE_SIZE>();
+
+static_assert(SIN_TABLE[SIN_TABLE_SIZE / 4] > 0.9999f); // sin(π/2) = 1 がコンパイル時に確かめられる
+
+inline float table_sin(float x)
+{
+    const float pos = x * (SIN_TABLE_SIZE / TWO_PI);
+    const float base = std::floor(pos);
+    const float frac = pos - base;
+    const auto i = static_cast<std::size_t>(static_cast<std::int64_t>(base) & (SIN_TABLE_SIZE - 1));
+    return SIN_TABLE[i] + (SIN_TABLE[i + 1] - SIN_TABLE[i]) * frac;
+}
+
+inline float table_cos(float x)
+{
+    return table_sin(x + HALF_PI);
+}
+
+// --- 多項式近似 ---
+namespace poly
+{
+    // π/2 を3つに分けて引くと、折り返しで失う桁を減らせる（Cody-Waite）
+    constexpr float TWO_OVER_PI = 0.636619772367581f;
+    constexpr float PIO2_1 = 1.5703125f;
+    constexpr float PIO2_2 = 4.837512969970703125e-4f;
+    constexpr float PIO2_3 = 7.54978995489188216e-8f;
+
+    // |r| <= π/4 での sin / cos（Cephes の sinf / cosf と同じ係数）
+    constexpr float S1 = -1.6666654611e-1f;
+    constexpr float S2 = 8.3321608736e-3f;
+    constexpr float S3 = -1.9515295891e-4f;
+    constexpr float C1 = 4.166664568298827e-2f;
+    constexpr float C2 = -1.388731625493765e-3f;
+    constexpr float C3 = 2.443315711809948e-5f;
+
+    // |t| <= tan(π/8) での atan
+    constexpr float A1 = -3.33329491539e-1f;
+    constexpr float A2 = 1.99777106478e-1f;
+    constexpr float A3 = -1.38776856032e-1f;
+    constexpr float A4 = 8.05374449538e-2f;
+    constexpr float TAN_PI_8 = 0.414213562373f;
+
+    inline float sin_kernel(float r)
+    {
+        const float z = r * r;
+        return r + r * z * (S1 + z * (S2 + z * S3));
+    }
+
+    inline float cos_kernel(float r)
+    {
+        const float z = r * r;
+        return 1.0f - 0.5f * z + z * z * (C1 + z * (C2 + z * C3));
+    }
+
+    // x = quadrant * π/2 + r に分ける
+    inline float reduce(float x, int& quadrant)
+    {
+        const float j = std::nearbyint(x * TWO_OVER_PI);
+        quadrant = static_cast<int>(j);
+        return ((x - j * PIO2_1) - j * PIO2_2) - j * PIO2_3;
+    }
+}
+
+inline float fast_sin(float x)
+{
+    int q;
+    const float r = poly::reduce(x, q);
+    const float v = (q & 1) ? poly::cos_kernel(r) : poly::sin_kernel(r);
+    return (q & 2) ? -v : v;
+}
+
+inline float fast_cos(float x)
+{
+    int q;
+    const float r = poly::reduce(x, q);
+    q += 1; // cos(x) = sin(x + π/2)
+    const float v = (q & 1) ? poly::cos_kernel(r) : poly::sin_kernel(r);
+    return (q & 2) ? -v : v;
+}
+
+inline float fast_atan2(float y, float x)
+{
+    const float ax = std::fabs(x);
+    const float ay = std::fabs(y);
+    const float mx = std::max(ax, ay);
+    const float mn = std::min(ax, ay);
+    float t = mx > 0.0f ? mn / mx : 0.0f; // 0〜1
+    float base = 0.0f;
+    if (t > poly::TAN_PI_8)
+    {
+        t = (t - 1.0f) / (t + 1.0f);
+        base = 0.25f * PI;
+    }
+    const float z = t * t;
+    float a = base + t + t * z * (poly::A1 + z * (poly::A2 + z * (poly::A3 + z * poly::A4)));
+    if (ay > ax)
+    {
+        a = HALF_PI - a;
+    }
+    if (x < 0.0f)
+    {
+        a = PI - a;
+    }
+    return std::signbit(y) ? -a : a;
+}
+
+// --- span 版：たくさんの角度をまとめて計算する ---
+#if defined(__AVX2__)
+namespace simd
+{
+    inline __m256 madd(__m256 a, __m256 b, __m256 c)
+    {
+#if defined(__FMA__)
+        return _mm256_fmadd_ps(a, b, c);
+#else
+        return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+    }
+
+    // 8個の sin と cos を同時に求める
+    inline void sincos(__m256 x, __m256& s, __m256& c)
+    {
+        const __m256 j = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(poly::TWO_OVER_PI)),
+                                         _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        __m256 r = _mm256_sub_ps(x, _mm256_mul_ps(j, _mm256_set1_ps(poly::PIO2_1)));
+        r = _mm256_sub_ps(r, _mm256_mul_ps(j, _mm256_set1_ps(poly::PIO2_2)));
+        r = _mm256_sub_ps(r, _mm256_mul_ps(j, _mm256_set1_ps(poly::PIO2_3)));
+        const __m256i q = _mm256_cvtps_epi32(j);
+
+        const __m256 z = _mm256_mul_ps(r, r);
+        __m256 ps = madd(z, _mm256_set1_ps(poly::S3), _mm256_set1_ps(poly::S2));
+        ps = madd(z, ps, _mm256_set1_ps(poly::S1));
+        ps = madd(_mm256_mul_ps(r, z), ps, r);
+        __m256 pc = madd(z, _mm256_set1_ps(poly::C3), _mm256_set1_ps(poly::C2));
+        pc = madd(z, pc, _mm256_set1_ps(poly::C1));
+        pc = madd(_mm256_mul_ps(z, z), pc, madd(z, _mm256_set1_ps(-0.5f), _mm256_set1_ps(1.0f)));
+
+        // 象限が奇数なら sin と cos を入れ替え、符号を反転する
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, one), one));
+        const __m256 sin_v = _mm256_blendv_ps(ps, pc, swap);
+        const __m256 cos_v = _mm256_blendv_ps(pc, ps, swap);
+        // sin は q の bit1、cos は (q+1) の bit1 が立っていれば負
+        const __m256 sin_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, _mm256_set1_epi32(2)), 30));
+        const __m256 cos_sign = _mm256_castsi256_ps(
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(q, one), _mm256_set1_epi32(2)), 30));
+        s = _mm256_xor_ps(sin_v, sin_sign);
+        c = _mm256_xor_ps(cos_v, cos_sign);
+    }
+
+    inline __m256 atan2(__m256 y, __m256 x)
+    {
+        const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+        const __m256 ax = _mm256_andnot_ps(sign_mask, x);
+        const __m256 ay = _mm256_andnot_ps(sign_mask, y);
+        const __m256 mx = _mm256_max_ps(ax, ay);
+        const __m256 mn = _mm256_min_ps(ax, ay);
+        // mx が 0 のときは 0 / 最小の正の数 = 0 になる
+        __m256 t = _mm256_div_ps(mn, _mm256_max_ps(mx, _mm256_set1_ps(1e-37f)));
+        const __m256 big = _mm256_cmp_ps(t, _mm256_set1_ps(poly::TAN_PI_8), _CMP_GT_OQ);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        t = _mm256_blendv_ps(t, _mm256_div_ps(_mm256_sub_ps(t, one), _mm256_add_ps(t, one)), big);
+        const __m256 base = _mm256_and_ps(big, _mm256_set1_ps(0.25f * PI));
+
+        const __m256 z = _mm256_mul_ps(t, t);
+        __m256 p = madd(z, _mm256_set1_ps(poly::A4), _mm256_set1_ps(poly::A3));
+        p = madd(z, p, _mm256_set1_ps(poly::A2));
+        p = madd(z, p, _mm256_set1_ps(poly::A1));
+        __m256 a = _mm256_add_ps(base, madd(_mm256_mul_ps(t, z), p, t));
+
+        a = _mm256_blendv_ps(a, _mm256_sub_ps(_mm256_set1_ps(HALF_PI), a), _mm256_cmp_ps(ay, ax, _CMP_GT_OQ));
+        a = _mm256_blendv_ps(a, _mm256_sub_ps(_mm256_set1_ps(PI), a), x); // x の符号ビットで選ぶ
+        return _mm256_xor_ps(a, _mm256_and_ps(y, sign_mask));
+    }
+}
+#endif
+
+// angles[i] の sin と cos を sines[i], cosines[i] に書く
+void fast_sincos(std::span<const float> angles, std::span<float> sines, std::span<float> cosines)
+{
+    const std::size_t n = std::min({ angles.size(), sines.size(), cosines.size() });
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 s, c;
+        simd::sincos(_mm256_loadu_ps(angles.data() + i), s, c);
+        _mm256_storeu_ps(sines.data() + i, s);
+        _mm256_storeu_ps(cosines.data() + i, c);
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        sines[i] = fast_sin(angles[i]);
+        cosines[i] = fast_cos(angles[i]);
+    }
+}
+
+void fast_atan2(std::span<const float> ys, std::span<const float> xs, std::span<float> out)
+{
+    const std::size_t n = std::min({ ys.size(), xs.size(), out.size() });
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 8 <= n; i += 8)
+    {
+        _mm256_storeu_ps(out.data() + i, simd::atan2(_mm256_loadu_ps(ys.data() + i), _mm256_loadu_ps(xs.data() + i)));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        out[i] = fast_atan2(ys[i], xs[i]);
+    }
+}
+
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::cout << "Deg2Rad(30) = " << Deg2Rad(30.0f) << " / fast_sin = " << fast_sin(Deg2Rad(30.0f))
+              << " / table_sin = " << table_sin(Deg2Rad(30.0f)) << "\n\n";
+
+    // --- 最大誤差を確かめる ---
+    {
+        constexpr int SAMPLES = 2'000'000;
+        std::vector<float> angles(SAMPLES), s(SAMPLES), c(SAMPLES);
+        for (int i = 0; i < SAMPLES; ++i)
+        {
+            angles[i] = -1000.0f + 2000.0f * static_cast<float>(i) / SAMPLES;
+        }
+        fast_sincos(angles, s, c);
+
+        double err_sin = 0, err_cos = 0, err_batch = 0, err_table = 0, err_table_small = 0;
+        for (int i = 0; i < SAMPLES; ++i)
+        {
+            const float a = -TWO_PI + 2.0f * TWO_PI * static_cast<float>(i) / SAMPLES;
+            err_table_small = std::max(err_table_small, std::fabs(table_sin(a) - std::sin(static_cast<double>(a))));
+        }
+        for (int i = 0; i < SAMPLES; ++i)
+        {
+            const double a = angles[i];
+            err_sin = std::max(err_sin, std::fabs(fast_sin(angles[i]) - std::sin(a)));
+            err_cos = std::max(err_cos, std::fabs(fast_cos(angles[i]) - std::cos(a)));
+            err_batch = std::max({ err_batch, std::fabs(s[i] - std::sin(a)), std::fabs(c[i] - std::cos(a)) });
+            err_table = std::max(err_table, std::fabs(table_sin(angles[i]) - std::sin(a)));
+        }
+
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+        std::vector<float> ys(SAMPLES), xs(SAMPLES), at(SAMPLES);
+        for (int i = 0; i < SAMPLES; ++i)
+        {
+            ys[i] = dist(rng);
+            xs[i] = dist(rng);
+        }
+        fast_atan2(ys, xs, at);
+        double err_atan = 0, err_atan_batch = 0;
+        for (int i = 0; i < SAMPLES; ++i)
+        {
+            const double ref = std::atan2(static_cast<double>(ys[i]), static_cast<double>(xs[i]));
+            err_atan = std::max(err_atan, std::fabs(fast_atan2(ys[i], xs[i]) - ref));
+            err_atan_batch = std::max(err_atan_batch, std::fabs(at[i] - ref));
+        }
+
+        std::cout << "最大誤差（|x| <= 1000）\n";
+        std::cout << "  fast_sin:        " << err_sin << "\n";
+        std::cout << "  fast_cos:        " << err_cos << "\n";
+        std::cout << "  fast_sincos(span): " << err_batch << "\n";
+        std::cout << "  table_sin:       " << err_table << "（|x| <= 2π では " << err_table_small << "）\n";
+        std::cout << "  fast_atan2:      " << err_atan << " / span 版: " << err_atan_batch << "\n\n";
+    }
+
+    // --- 敵の向きと移動：std:: と比べる ---
+    constexpr int ENEMIES = 1 << 20; // MAX_ENEMY の部屋をたくさん並べたつもり
+    std::vector<float> ex(ENEMIES), ey(ENEMIES), facing(ENEMIES), vx(ENEMIES), vy(ENEMIES), sn(ENEMIES), cs(ENEMIES);
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> pos(-500.0f, 500.0f);
+    for (int i = 0; i < ENEMIES; ++i)
+    {
+        ex[i] = pos(rng);
+        ey[i] = pos(rng);
+    }
+    const float player_x = 10.0f;
+    const float player_y = -20.0f;
+    const float speed = 2.0f;
+
+    auto bench = [&](const char* label, auto body)
+        {
+            const auto start = Clock::now();
+            body();
+            const auto us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+            double check = 0;
+            for (int i = 0; i < ENEMIES; i += 4096)
+            {
+                check += vx[i] + vy[i];
+            }
+            std::cout << label << us << "us (検算 " << check << ")\n";
+        };
+
+    bench("std::atan2 + sin/cos:  ", [&]()
+        {
+            for (int i = 0; i < ENEMIES; ++i)
+            {
+                const float a = std::atan2(player_y - ey[i], player_x - ex[i]);
+                vx[i] = std::cos(a) * speed;
+                vy[i] = std::sin(a) * speed;
+            }
+        });
+    bench("fast_atan2 + sin/cos:  ", [&]()
+        {
+            for (int i = 0; i < ENEMIES; ++i)
+            {
+                const float a = fast_atan2(player_y - ey[i], player_x - ex[i]);
+                vx[i] = fast_cos(a) * speed;
+                vy[i] = fast_sin(a) * speed;
+            }
+        });
+    bench("span 版（まとめて計算）:", [&]()
+        {
+            for (int i = 0; i < ENEMIES; ++i)
+            {
+                vx[i] = player_x - ex[i]; // いったん差分を入れておく
+                vy[i] = player_y - ey[i];
+            }
+            fast_atan2(vy, vx, facing);
+            fast_sincos(facing, sn, cs);
+            for (int i = 0; i < ENEMIES; ++i)
+            {
+                vx[i] = cs[i] * speed;
+                vy[i] = sn[i] * speed;
+            }
+        });
+
+    return 0;
+}
@@ -0,0 +1,421 @@
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// --- constexpr の上限で大きさが決まる、ヒープを使わない入れ物 ---
+// lesson11_4 の MAX_ENEMY は宣言されているだけで、何の大きさにも使われていなかった。
+// 部屋ごとの敵の数に上限があるなら、std::vector のようにヒープを使う必要はない。
+//
+//   static_vector<T, N>     … 最大 N 個の可変長配列（要素はオブジェクトの中に直接置く）
+//   FixedPool<T, N>         … N 個分の置き場所と「使用中」のビット列。番号で出し入れする
+//   FixedHashMap<K, V, N>   … 最大 N 個のハッシュマップ（オープンアドレス法）
+//
+// 要素数や番号の型は、N が入る一番小さい整数型（N = 32 なら uint8_t）になる
+
+constexpr int MAX_ENEMY = 32;
+
+// N までの値が入る一番小さい符号なし整数型
+template<std::size_t N>
+using smallest_index_t =
+    std::conditional_t<N <= std::numeric_limits<std::uint8_t>::max(), std::uint8_t,
+    std::conditional_t<N <= std::numeric_limits<std::uint16_t>::max(), std::uint16_t,
+    std::conditional_t<N <= std::numeric_limits<std::uint32_t>::max(), std::uint32_t, std::uint64_t>>>;
+
+static_assert(std::is_same_v<smallest_index_t<MAX_ENEMY>, std::uint8_t>);
+static_assert(std::is_same_v<smallest_index_t<1000>, std::uint16_t>);
+
+// --- static_vector ---
+template<typename T, std::size_t N>
+class static_vector
+{
+public:
+    using size_type = smallest_index_t<N>;
+
+    static_vector() = default;
+
+    static_vector(const static_vector& other)
+    {
+        for (const T& v : other)
+        {
+            emplace_back(v);
+        }
+    }
+
+    static_vector(static_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        for (T& v : other)
+        {
+            emplace_back(std::move(v));
+        }
+        other.clear();
+    }
+
+    static_vector& operator=(static_vector other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        // 中身はオブジェクトの中にあるので、ポインタの付け替えではなく要素ごとに移す
+        clear();
+        for (T& v : other)
+        {
+            emplace_back(std::move(v));
+        }
+        return *this;
+    }
+
+    ~static_vector()
+    {
+        clear();
+    }
+
+    static constexpr std::size_t capacity() { return N; }
+    std::size_t size() const { return size_; }
+    bool        empty() const { return size_ == 0; }
+    bool        full() const { return size_ == N; }
+
+    T*       data() { return std::launder(reinterpret_cast<T*>(storage_)); }
+    const T* data() const { return std::launder(reinterpret_cast<const T*>(storage_)); }
+    T*       begin() { return data(); }
+    T*       end() { return data() + size_; }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + size_; }
+
+    T&       operator[](std::size_t i) { return data()[i]; }
+    const T& operator[](std::size_t i) const { return data()[i]; }
+
+    // いっぱいなら nullptr を返す（例外を使わない版）
+    template<typename... Args>
+    T* try_emplace_back(Args&&... args)
+    {
+        if (full())
+        {
+            return nullptr;
+        }
+        T* p = ::new (static_cast<void*>(data() + size_)) T(std::forward<Args>(args)...);
+        ++size_;
+        return p;
+    }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        T* p = try_emplace_back(std::forward<Args>(args)...);
+        if (p == nullptr)
+        {
+            throw std::length_error("static_vector: 容量を超えました");
+        }
+        return *p;
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    void pop_back()
+    {
+        data()[--size_].~T();
+    }
+
+    // i 番目を末尾の要素で埋めて取り除く（順序は変わるが O(1)）
+    void swap_erase(std::size_t i)
+    {
+        if (i != size_ - 1u)
+        {
+            data()[i] = std::move(data()[size_ - 1u]);
+        }
+        pop_back();
+    }
+
+    void clear()
+    {
+        std::destroy_n(data(), size_);
+        size_ = 0;
+    }
+
+private:
+    alignas(T) std::byte storage_[sizeof(T) * N];
+    size_type size_ = 0;
+};
+
+// --- FixedPool：使用中かどうかをビット列で管理する置き場所 ---
+template<typename T, std::size_t N>
+class FixedPool
+{
+public:
+    using index_type = smallest_index_t<N>;
+    static constexpr index_type INVALID = std::numeric_limits<index_type>::max();
+    static_assert(N < INVALID, "番号の型に「無効」を表す値が残らない");
+
+    FixedPool() = default;
+    FixedPool(const FixedPool&) = delete;
+    FixedPool& operator=(const FixedPool&) = delete;
+
+    ~FixedPool()
+    {
+        for_each_index([this](index_type i) { get(i).~T(); });
+    }
+
+    // 空いている一番若い番号に作る。いっぱいなら INVALID
+    template<typename... Args>
+    index_type create(Args&&... args)
+    {
+        for (std::size_t w = 0; w < WORDS; ++w)
+        {
+            const std::uint64_t free_bits = ~used_[w] & valid_mask(w);
+            if (free_bits != 0)
+            {
+                const auto bit = static_cast<std::size_t>(std::countr_zero(free_bits));
+                const auto index = static_cast<index_type>(w * 64 + bit);
+                ::new (static_cast<void*>(slot(index))) T(std::forward<Args>(args)...);
+                used_[w] |= std::uint64_t{ 1 } << bit;
+                ++count_;
+                return index;
+            }
+        }
+        return INVALID;
+    }
+
+    void destroy(index_type index)
+    {
+        if (!alive(index))
+        {
+            return;
+        }
+        get(index).~T();
+        used_[index / 64] &= ~(std::uint64_t{ 1 } << (index % 64));
+        --count_;
+    }
+
+    bool alive(index_type index) const
+    {
+        return index < N && (used_[index / 64] >> (index % 64)) & 1;
+    }
+
+    T&       get(index_type index) { return *std::launder(slot(index)); }
+    const T& get(index_type index) const { return *std::launder(slot(index)); }
+    std::size_t size() const { return count_; }
+
+    // 使用中の番号だけを、ビット列をたどって順に渡す
+    template<typename F>
+    void for_each_index(F&& f) const
+    {
+        for (std::size_t w = 0; w < WORDS; ++w)
+        {
+            for (std::uint64_t bits = used_[w]; bits != 0; bits &= bits - 1)
+            {
+                f(static_cast<index_type>(w * 64 + static_cast<std::size_t>(std::countr_zero(bits))));
+            }
+        }
+    }
+
+private:
+    static constexpr std::size_t WORDS = (N + 63) / 64;
+
+    static constexpr std::uint64_t valid_mask(std::size_t word)
+    {
+        const std::size_t remain = N - word * 64;
+        return remain >= 64 ? ~std::uint64_t{ 0 } : (std::uint64_t{ 1 } << remain) - 1;
+    }
+
+    T*       slot(index_type i) { return reinterpret_cast<T*>(storage_ + sizeof(T) * i); }
+    const T* slot(index_type i) const { return reinterpret_cast<const T*>(storage_ + sizeof(T) * i); }
+
+    alignas(T) std::byte               storage_[sizeof(T) * N];
+    std::array<std::uint64_t, WORDS>   used_{};
+    index_type                         count_ = 0;
+};
+
+// --- FixedHashMap：最大 N 個のキーを持つハッシュマップ ---
+// 表の大きさは N の2倍以上の 2 のべき乗にして、埋まり具合を半分以下に保つ。
+// 削除は後ろの要素を詰め直す方式なので、「削除済み」の印が溜まって遅くなることがない。
+// K と V はデフォルト構築できる型に限る
+template<typename K, typename V, std::size_t N>
+class FixedHashMap
+{
+public:
+    static constexpr std::size_t SLOTS = std::bit_ceil(N * 2);
+    using size_type = smallest_index_t<N>;
+
+    // 入れたら true。すでにあれば値を上書きして true。いっぱいなら false
+    bool insert_or_assign(const K& key, const V& value)
+    {
+        std::size_t i = home(key);
+        while (used_[i])
+        {
+            if (keys_[i] == key)
+            {
+                values_[i] = value;
+                return true;
+            }
+            i = (i + 1) & (SLOTS - 1);
+        }
+        if (count_ == N)
+        {
+            return false;
+        }
+        used_[i] = true;
+        keys_[i] = key;
+        values_[i] = value;
+        ++count_;
+        return true;
+    }
+
+    V* find(const K& key)
+    {
+        for (std::size_t i = home(key); used_[i]; i = (i + 1) & (SLOTS - 1))
+        {
+            if (keys_[i] == key)
+            {
+                return &values_[i];
+            }
+        }
+        return nullptr;
+    }
+
+    bool erase(const K& key)
+    {
+        std::size_t i = home(key);
+        while (used_[i] && !(keys_[i] == key))
+        {
+            i = (i + 1) & (SLOTS - 1);
+        }
+        if (!used_[i])
+        {
+            return false;
+        }
+        // 後ろに続く要素のうち、本来の位置が空いた場所より前にあるものを詰める
+        std::size_t hole = i;
+        for (std::size_t j = (i + 1) & (SLOTS - 1); used_[j]; j = (j + 1) & (SLOTS - 1))
+        {
+            const std::size_t h = home(keys_[j]);
+            if (((j - h) & (SLOTS - 1)) >= ((j - hole) & (SLOTS - 1)))
+            {
+                keys_[hole] = std::move(keys_[j]);
+                values_[hole] = std::move(values_[j]);
+                hole = j;
+            }
+        }
+        used_[hole] = false;
+        --count_;
+        return true;
+    }
+
+    std::size_t size() const { return count_; }
+
+private:
+    static std::size_t home(const K& key)
+    {
+        // 整数のキーは連番になりがちなので、かき混ぜてから下位ビットを使う
+        std::uint64_t h = static_cast<std::uint64_t>(std::hash<K>{}(key));
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return static_cast<std::size_t>(h) & (SLOTS - 1);
+    }
+
+    std::array<K, SLOTS>    keys_{};
+    std::array<V, SLOTS>    values_{};
+    std::array<bool, SLOTS> used_{};
+    size_type               count_ = 0;
+};
+
+// --- ヒープを使っていないことを確かめるため、operator new の呼び出しを数える ---
+static std::size_t g_heap_allocs = 0;
+
+void* operator new(std::size_t size)
+{
+    ++g_heap_allocs;
+    if (void* p = std::malloc(size))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+struct Enemy
+{
+    std::string_view name; // 名前は静的な文字列を指すだけにする
+    int              id;
+    int              hp;
+};
+
+// 1つの部屋の敵。すべてが Room の中に収まる
+struct Room
+{
+    static_vector<Enemy, MAX_ENEMY>                           spawn_queue;
+    FixedPool<Enemy, MAX_ENEMY>                               enemies;
+    FixedHashMap<int, FixedPool<Enemy, MAX_ENEMY>::index_type, MAX_ENEMY> by_id; // id → 番号
+};
+
+int main()
+{
+    std::cout << "static_vector<Enemy, " << MAX_ENEMY << "> の要素数の型: "
+              << sizeof(static_vector<Enemy, MAX_ENEMY>::size_type) << "バイト\n";
+    std::cout << "FixedPool の番号の型: " << sizeof(FixedPool<Enemy, MAX_ENEMY>::index_type) << "バイト\n";
+    std::cout << "Room 全体: " << sizeof(Room) << "バイト（ヒープは使わない）\n\n";
+
+    const std::size_t allocs_before = g_heap_allocs;
+    Room room;
+
+    // 出現予定を積む
+    constexpr std::string_view NAMES[] = { "スライム", "ゴブリン", "オーク" };
+    for (int i = 0; i < 40; ++i)
+    {
+        if (room.spawn_queue.try_emplace_back(Enemy{ NAMES[i % 3], 100 + i, 30 + i }) == nullptr)
+        {
+            std::cout << "出現予定がいっぱい（" << room.spawn_queue.size() << "体）: id " << 100 + i << " は次の部屋へ\n";
+            break;
+        }
+    }
+
+    // 出現予定からプールに出し、id で引けるようにする
+    for (const Enemy& e : room.spawn_queue)
+    {
+        const auto index = room.enemies.create(e);
+        room.by_id.insert_or_assign(e.id, index);
+    }
+    room.spawn_queue.clear();
+
+    // id で探してダメージを与え、倒したらプールと表から消す
+    for (int id : { 100, 105, 131, 999 })
+    {
+        if (auto* index = room.by_id.find(id))
+        {
+            Enemy& e = room.enemies.get(*index);
+            e.hp -= 50;
+            std::cout << e.name << "(id " << id << ") に50ダメージ! 残りHP:" << e.hp << "\n";
+            if (e.hp <= 0)
+            {
+                room.enemies.destroy(*index);
+                room.by_id.erase(id);
+            }
+        }
+        else
+        {
+            std::cout << "id " << id << " はいません\n";
+        }
+    }
+
+    // 空いた番号は再利用される
+    const auto reused = room.enemies.create(Enemy{ "ドラゴン", 200, 500 });
+    room.by_id.insert_or_assign(200, reused);
+    std::cout << "ドラゴンの番号: " << static_cast<int>(reused) << "\n";
+
+    int total_hp = 0;
+    room.enemies.for_each_index([&](auto i) { total_hp += room.enemies.get(i).hp; });
+    std::cout << "敵 " << room.enemies.size() << "体 / id の表 " << room.by_id.size()
+              << "件 / HP 合計 " << total_hp << "\n";
+
+    std::cout << "ヒープ確保: " << g_heap_allocs - allocs_before << "回\n";
+    return 0;
+}
@@ -0,0 +1,300 @@
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+// --- サブシステムごとのメモリ確保の追跡 ---
+// std::string の名前、new Enemy、make_shared、vector の拡張…と、ヒープ確保はあちこちに隠れている。
+// グローバルな operator new / operator delete を置き換え、
+// 「今どのサブシステムの処理中か」というタグごとに回数・バイト数・ピーク・サイズ分布を数える。
+//
+// タグは RAII の AllocScope で付ける（lesson15_5 の Stage と同じく、スコープを抜けると元に戻る）
+//
+//   {
+//       AllocScope scope(TAG_COMBAT);
+//       auto boss = std::make_unique<Boss>(...); // Combat として数えられる
+//   }
+//
+// ALLOC_TRACKING=0 でコンパイルすると operator new の置き換え自体がなくなる（コストはゼロ）。
+// 有効でも alloc_tracking_enabled を false にしておけば、タグの読み込みと分岐1つ分しかかからない
+
+#ifndef ALLOC_TRACKING
+#define ALLOC_TRACKING 1
+#endif
+
+namespace alloc_tracker
+{
+    constexpr int MAX_TAGS = 16;
+    constexpr int HISTOGRAM_BUCKETS = 12; // 〜16B, 〜32B, … 〜16KB, それ以上
+
+    struct TagStats
+    {
+        std::atomic<std::uint64_t> allocs{ 0 };
+        std::atomic<std::uint64_t> frees{ 0 };
+        std::atomic<std::uint64_t> total_bytes{ 0 };
+        std::atomic<std::int64_t>  live_bytes{ 0 };
+        std::atomic<std::int64_t>  peak_bytes{ 0 };
+        std::array<std::atomic<std::uint64_t>, HISTOGRAM_BUCKETS> histogram{};
+    };
+
+    // 名前とカウンタは固定長の配列に置く（追跡のために new を呼ぶと無限に再帰するので）
+    inline std::array<const char*, MAX_TAGS> g_tag_names{ "Untagged" };
+    inline std::array<TagStats, MAX_TAGS>    g_stats;
+    inline std::atomic<int>                  g_tag_count{ 1 };
+    inline std::atomic<bool>                 g_enabled{ true };
+    inline thread_local int                  t_current_tag = 0;
+
+    inline int register_tag(const char* name)
+    {
+        const int id = g_tag_count.fetch_add(1);
+        if (id >= MAX_TAGS)
+        {
+            std::fputs("alloc_tracker: タグが多すぎます\n", stderr);
+            std::abort();
+        }
+        g_tag_names[id] = name;
+        return id;
+    }
+
+    inline int bucket_of(std::size_t size)
+    {
+        int b = 0;
+        for (std::size_t limit = 16; size > limit && b < HISTOGRAM_BUCKETS - 1; limit <<= 1)
+        {
+            ++b;
+        }
+        return b;
+    }
+
+    inline void on_alloc(int tag, std::size_t size)
+    {
+        TagStats& s = g_stats[tag];
+        s.allocs.fetch_add(1, std::memory_order_relaxed);
+        s.total_bytes.fetch_add(size, std::memory_order_relaxed);
+        s.histogram[bucket_of(size)].fetch_add(1, std::memory_order_relaxed);
+        const std::int64_t live = s.live_bytes.fetch_add(static_cast<std::int64_t>(size), std::memory_order_relaxed)
+                                + static_cast<std::int64_t>(size);
+        std::int64_t peak = s.peak_bytes.load(std::memory_order_relaxed);
+        while (live > peak && !s.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    inline void on_free(int tag, std::size_t size)
+    {
+        TagStats& s = g_stats[tag];
+        s.frees.fetch_add(1, std::memory_order_relaxed);
+        s.live_bytes.fetch_sub(static_cast<std::int64_t>(size), std::memory_order_relaxed);
+    }
+
+    // 1フレームごとの差分を出すため、前回の値を覚えておく
+    class FrameReporter
+    {
+    public:
+        // 前回呼んでからの確保回数・バイト数を、動きのあったタグだけ出力する
+        void report(std::ostream& os, int frame)
+        {
+            os << "[frame " << frame << "]";
+            bool any = false;
+            for (int t = 0; t < g_tag_count.load(); ++t)
+            {
+                const std::uint64_t allocs = g_stats[t].allocs.load(std::memory_order_relaxed);
+                const std::uint64_t bytes = g_stats[t].total_bytes.load(std::memory_order_relaxed);
+                if (allocs != last_allocs_[t])
+                {
+                    os << " " << g_tag_names[t] << ": " << allocs - last_allocs_[t] << "回/"
+                       << bytes - last_bytes_[t] << "B";
+                    any = true;
+                }
+                last_allocs_[t] = allocs;
+                last_bytes_[t] = bytes;
+            }
+            os << (any ? "" : " 確保なし") << "\n";
+        }
+
+    private:
+        std::array<std::uint64_t, MAX_TAGS> last_allocs_{};
+        std::array<std::uint64_t, MAX_TAGS> last_bytes_{};
+    };
+
+    inline void print_summary(std::ostream& os)
+    {
+        os << "tag        allocs   frees    live(B)   peak(B)   total(B)  sizes(16,32,64,...)\n";
+        for (int t = 0; t < g_tag_count.load(); ++t)
+        {
+            const TagStats& s = g_stats[t];
+            char line[128];
+            std::snprintf(line, sizeof(line), "%-10s %-8llu %-8llu %-9lld %-9lld %-9llu ",
+                          g_tag_names[t],
+                          static_cast<unsigned long long>(s.allocs.load()),
+                          static_cast<unsigned long long>(s.frees.load()),
+                          static_cast<long long>(s.live_bytes.load()),
+                          static_cast<long long>(s.peak_bytes.load()),
+                          static_cast<unsigned long long>(s.total_bytes.load()));
+            os << line;
+            for (const auto& h : s.histogram)
+            {
+                os << h.load() << " ";
+            }
+            os << "\n";
+        }
+    }
+
+    // 確保したブロックの直前に置く情報（解放時にサイズとタグを知るため）
+    struct alignas(16) Header
+    {
+        std::size_t   size;
+        std::uint32_t tag;
+        std::uint32_t offset; // 本来の先頭からユーザー領域までの距離
+    };
+    static_assert(sizeof(Header) == 16);
+
+    inline void* allocate(std::size_t size, std::size_t alignment)
+    {
+        void* base;
+        std::size_t offset = sizeof(Header);
+        if (alignment <= alignof(std::max_align_t))
+        {
+            base = std::malloc(size + offset);
+        }
+        else
+        {
+            offset = alignment; // ヘッダの分だけ、アラインメント1つ分ずらす
+            base = std::aligned_alloc(alignment, (size + offset + alignment - 1) / alignment * alignment);
+        }
+        if (base == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+
+        const int tag = g_enabled.load(std::memory_order_relaxed) ? t_current_tag : -1;
+        auto* user = static_cast<unsigned char*>(base) + offset;
+        ::new (user - sizeof(Header)) Header{ size, static_cast<std::uint32_t>(tag), static_cast<std::uint32_t>(offset) };
+        if (tag >= 0)
+        {
+            on_alloc(tag, size);
+        }
+        return user;
+    }
+
+    inline void deallocate(void* p) noexcept
+    {
+        if (p == nullptr)
+        {
+            return;
+        }
+        auto* user = static_cast<unsigned char*>(p);
+        const Header* h = reinterpret_cast<const Header*>(user - sizeof(Header));
+        if (static_cast<int>(h->tag) >= 0) // 追跡していた確保だけを数える
+        {
+            on_free(static_cast<int>(h->tag), h->size);
+        }
+        std::free(user - h->offset);
+    }
+}
+
+// 現在のスレッドのタグをスコープの間だけ切り替える
+class AllocScope
+{
+public:
+    explicit AllocScope(int tag) : previous_(alloc_tracker::t_current_tag)
+    {
+        alloc_tracker::t_current_tag = tag;
+    }
+
+    ~AllocScope()
+    {
+        alloc_tracker::t_current_tag = previous_;
+    }
+
+    AllocScope(const AllocScope&) = delete;
+    AllocScope& operator=(const AllocScope&) = delete;
+
+private:
+    int previous_;
+};
+
+#if ALLOC_TRACKING
+// --- グローバルな operator new / delete の置き換え ---
+// 配列版・nothrow 版・サイズつき delete の既定の実装は、ここで置き換えた関数を呼ぶ
+void* operator new(std::size_t size)
+{
+    return alloc_tracker::allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return alloc_tracker::allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept { alloc_tracker::deallocate(p); }
+void operator delete(void* p, std::size_t) noexcept { alloc_tracker::deallocate(p); }
+void operator delete(void* p, std::align_val_t) noexcept { alloc_tracker::deallocate(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { alloc_tracker::deallocate(p); }
+#endif
+
+// --- サブシステムのタグ ---
+const int TAG_STAGE  = alloc_tracker::register_tag("Stage");
+const int TAG_COMBAT = alloc_tracker::register_tag("Combat");
+const int TAG_RENDER = alloc_tracker::register_tag("Render");
+
+struct Enemy
+{
+    std::string name;
+    int         hp;
+};
+
+int main()
+{
+    alloc_tracker::FrameReporter reporter;
+    std::vector<std::shared_ptr<Enemy>> enemies;
+    std::vector<int> draw_list;
+
+    {
+        AllocScope scope(TAG_STAGE);
+        // ステージ読み込み：長い名前は std::string がヒープを使う
+        for (int i = 0; i < 8; ++i)
+        {
+            enemies.push_back(std::make_shared<Enemy>(Enemy{ "ステージ1のゴブリン兵" + std::to_string(i), 30 }));
+        }
+    }
+    reporter.report(std::cout, 0);
+
+    for (int frame = 1; frame <= 3; ++frame)
+    {
+        {
+            AllocScope scope(TAG_COMBAT);
+            Enemy* summoned = new Enemy{ "召喚されたスケルトン", 10 }; // 毎フレームの new
+            delete summoned;
+        }
+        {
+            AllocScope scope(TAG_RENDER);
+            for (int i = 0; i < 100 * frame; ++i)
+            {
+                draw_list.push_back(i); // vector の拡張
+            }
+        }
+        reporter.report(std::cout, frame);
+    }
+
+    // 計測を止めている間はカウンタが変わらない
+    alloc_tracker::g_enabled = false;
+    {
+        AllocScope scope(TAG_COMBAT);
+        auto ignored = std::make_unique<Enemy>(Enemy{ "計測対象外のスライム", 5 });
+    }
+    alloc_tracker::g_enabled = true;
+    reporter.report(std::cout, 4);
+
+    std::cout << "\n";
+    alloc_tracker::print_summary(std::cout);
+
+    return 0;
+}
@@ -0,0 +1,889 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// --- 非同期ファイル I/O を持つ FileManager（Linux） ---
+// lesson17_6 の FileManager は「開きました」「閉じました」と表示するだけだった。
+// ここではコンストラクタで本当にファイルを開き、デストラクタで閉じる。
+// ただし書き込みはゲームのスレッドで待たず、io_uring（IORING_OP_READ / WRITE を使うので Linux 5.6〜）でまとめて OS に渡す。
+// io_uring が使えない環境では、スレッドプールで pread / pwrite を呼ぶ方式に切り替える。
+//
+//   - IoBatch に読み書きを溜めて submit() すると、システムコール1回でまとめて発行される
+//   - 完了はコールバック（完了用スレッドで呼ばれる）か std::future で受け取る
+//   - register_buffers() で登録したバッファは、カーネルが毎回ページを固定し直さずに済む
+//   - デストラクタは発行済みの I/O がすべて終わるのを待ってから close する
+//
+// liburing は使わず、io_uring_setup / io_uring_enter / io_uring_register を直接呼んでいる
+
+// I/O の結果：成功なら転送したバイト数、失敗なら -errno
+struct IoResult
+{
+    int value = 0;
+
+    bool        ok() const { return value >= 0; }
+    std::size_t bytes() const { return ok() ? static_cast<std::size_t>(value) : 0; }
+    std::string error() const { return ok() ? "" : std::strerror(-value); }
+};
+
+using IoCallback = std::function<void(IoResult)>;
+
+// 1件の読み書きの依頼
+struct IoRequest
+{
+    enum class Op
+    {
+        Read,
+        Write,
+    };
+
+    Op          op;
+    std::byte*  data;
+    std::size_t length;
+    std::size_t offset;
+    int         buffer_index; // 登録済みバッファを使うときの番号（使わないなら -1）
+    IoCallback  callback;
+};
+
+// submit() でまとめて発行する読み書きの集まり
+class IoBatch
+{
+public:
+    IoBatch& read(std::span<std::byte> buffer, std::size_t offset, IoCallback callback = {})
+    {
+        requests_.push_back({ IoRequest::Op::Read, buffer.data(), buffer.size(), offset, -1, std::move(callback) });
+        return *this;
+    }
+
+    IoBatch& write(std::span<const std::byte> data, std::size_t offset, IoCallback callback = {})
+    {
+        // 書き込みでも io_uring にはポインタを渡すだけなので、const を外して持っておく
+        requests_.push_back({ IoRequest::Op::Write, const_cast<std::byte*>(data.data()), data.size(), offset, -1, std::move(callback) });
+        return *this;
+    }
+
+    // register_buffers() で登録した index 番目のバッファの先頭 length バイトを使う
+    IoBatch& read_fixed(int index, std::span<std::byte> buffer, std::size_t offset, IoCallback callback = {})
+    {
+        requests_.push_back({ IoRequest::Op::Read, buffer.data(), buffer.size(), offset, index, std::move(callback) });
+        return *this;
+    }
+
+    IoBatch& write_fixed(int index, std::span<const std::byte> data, std::size_t offset, IoCallback callback = {})
+    {
+        requests_.push_back({ IoRequest::Op::Write, const_cast<std::byte*>(data.data()), data.size(), offset, index, std::move(callback) });
+        return *this;
+    }
+
+    std::size_t size() const { return requests_.size(); }
+
+private:
+    friend class AsyncFile;
+    std::vector<IoRequest> requests_;
+};
+
+// --- バックエンドの共通インターフェース ---
+class IoBackend
+{
+public:
+    virtual ~IoBackend() = default;
+    virtual const char* name() const = 0;
+    virtual void register_buffers(std::span<const std::span<std::byte>> buffers) = 0;
+    virtual void submit(int fd, std::vector<IoRequest>& requests) = 0;
+    virtual void shutdown() = 0; // 完了待ちのスレッドを止める（発行済みの I/O は終わっている前提）
+};
+
+// --- close / munmap し忘れないための小さな持ち主 ---
+// コンストラクタの途中で例外が出ても、できあがったメンバのデストラクタは呼ばれる
+class UniqueFd
+{
+public:
+    explicit UniqueFd(int fd = -1) : fd_(fd) {}
+    ~UniqueFd()
+    {
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+        }
+    }
+
+    UniqueFd(UniqueFd&& other) noexcept : fd_(std::exchange(other.fd_, -1)) {}
+    UniqueFd& operator=(UniqueFd&& other) noexcept
+    {
+        std::swap(fd_, other.fd_);
+        return *this;
+    }
+
+    int get() const { return fd_; }
+
+private:
+    int fd_;
+};
+
+class Mapping
+{
+public:
+    Mapping() = default;
+    Mapping(int fd, std::size_t size, off_t offset)
+        : data_(::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset))
+        , size_(size)
+    {
+        if (data_ == MAP_FAILED)
+        {
+            data_ = nullptr;
+            throw std::runtime_error("io_uring のリングをマップできませんでした");
+        }
+    }
+    ~Mapping()
+    {
+        if (data_ != nullptr)
+        {
+            ::munmap(data_, size_);
+        }
+    }
+
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+
+    std::byte* get() const { return static_cast<std::byte*>(data_); }
+
+private:
+    void*       data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+// --- io_uring バックエンド ---
+class UringBackend : public IoBackend
+{
+public:
+    // 作れなければ nullptr（古いカーネル、seccomp で禁止されている環境、リングをマップできないときなど）。
+    // nullptr なら呼び出し側はスレッドプールの pread / pwrite に切り替える
+    static std::unique_ptr<UringBackend> create(unsigned entries, std::function<void()> on_complete)
+    {
+        io_uring_params params{};
+        UniqueFd ring_fd(static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params)));
+        if (ring_fd.get() < 0 || !supports_used_ops(ring_fd.get()))
+        {
+            return nullptr;
+        }
+        try
+        {
+            return std::unique_ptr<UringBackend>(new UringBackend(std::move(ring_fd), params, std::move(on_complete)));
+        }
+        catch (const std::exception&)
+        {
+            return nullptr; // リングのマップや完了用スレッドの作成に失敗した
+        }
+    }
+
+    // リングとファイルディスクリプタはメンバのデストラクタが片付ける
+    ~UringBackend() override
+    {
+        shutdown();
+    }
+
+    const char* name() const override { return "io_uring"; }
+
+    void register_buffers(std::span<const std::span<std::byte>> buffers) override
+    {
+        std::vector<iovec> iov;
+        for (const auto& b : buffers)
+        {
+            iov.push_back({ b.data(), b.size() });
+        }
+        if (::syscall(__NR_io_uring_register, ring_fd_.get(), IORING_REGISTER_BUFFERS, iov.data(), iov.size()) < 0)
+        {
+            throw std::runtime_error(std::string("バッファを登録できませんでした: ") + std::strerror(errno));
+        }
+    }
+
+    // 発行できなかった依頼は、エラーの結果でコールバックを呼んで完了扱いにする（このスレッドで呼ばれる）
+    void submit(int fd, std::vector<IoRequest>& requests) override
+    {
+        std::vector<Pending*> pending;
+        pending.reserve(requests.size());
+        for (auto& r : requests)
+        {
+            pending.push_back(new Pending{ fd, std::move(r), 0 });
+        }
+        std::lock_guard lock(submit_mutex_);
+        std::size_t i = 0;
+        while (i < pending.size())
+        {
+            const int ret = push(pending, i);
+            if (ret == -EAGAIN || ret == -EBUSY)
+            {
+                // カーネルの資源か CQ がいっぱい。完了が1件出るまで待ってから続ける
+                enter(0, 1, IORING_ENTER_GETEVENTS);
+            }
+            else if (ret < 0)
+            {
+                for (; i < pending.size(); ++i)
+                {
+                    fail(pending[i], ret);
+                }
+            }
+        }
+    }
+
+    void shutdown() override
+    {
+        if (!completer_.joinable())
+        {
+            return;
+        }
+        // user_data = 0 の NOP を流して、完了待ちのスレッドを起こして終わらせる
+        {
+            std::lock_guard lock(submit_mutex_);
+            const unsigned tail = *sq_tail_;
+            const unsigned index = tail & *sq_mask_;
+            std::memset(&sqes_[index], 0, sizeof(io_uring_sqe));
+            sqes_[index].opcode = IORING_OP_NOP;
+            sq_array_[index] = index;
+            std::atomic_ref(*sq_tail_).store(tail + 1, std::memory_order_release);
+            enter(1, 0, 0);
+        }
+        completer_.join();
+    }
+
+private:
+    // 発行中の1件。途中までしか転送できなかったら、残りを同じ Pending で出し直す
+    struct Pending
+    {
+        int         fd;
+        IoRequest   request;
+        std::size_t done;
+    };
+
+    // io_uring_setup が通っても、使う命令がそろっているとは限らない（READ / WRITE は 5.6 から）。
+    // IORING_REGISTER_PROBE 自体も 5.6 からなので、失敗したら古いカーネルとみなす
+    static bool supports_used_ops(int ring_fd)
+    {
+        constexpr unsigned MAX_OPS = 256;
+        std::vector<std::byte> buffer(sizeof(io_uring_probe) + MAX_OPS * sizeof(io_uring_probe_op));
+        auto* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+        if (::syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PROBE, probe, MAX_OPS) < 0)
+        {
+            return false;
+        }
+        for (const unsigned op : { IORING_OP_NOP, IORING_OP_READ, IORING_OP_WRITE, IORING_OP_READ_FIXED, IORING_OP_WRITE_FIXED })
+        {
+            if (op > probe->last_op || (probe->ops[op].flags & IO_URING_OP_SUPPORTED) == 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    UringBackend(UniqueFd ring_fd, const io_uring_params& p, std::function<void()> on_complete)
+        : ring_fd_(std::move(ring_fd))
+        , sq_entries_(p.sq_entries)
+        , on_complete_(std::move(on_complete))
+    {
+        std::size_t sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        std::size_t cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        const bool single_mmap = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap)
+        {
+            sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+        }
+
+        // ここで例外が出ても、ring_fd_ とマップ済みの領域はメンバのデストラクタが片付ける（create が nullptr にする）
+        sq_map_ = std::make_unique<Mapping>(ring_fd_.get(), sq_ring_size, IORING_OFF_SQ_RING);
+        if (!single_mmap)
+        {
+            cq_map_ = std::make_unique<Mapping>(ring_fd_.get(), cq_ring_size, IORING_OFF_CQ_RING);
+        }
+        sqe_map_ = std::make_unique<Mapping>(ring_fd_.get(), p.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES);
+        sqes_ = reinterpret_cast<io_uring_sqe*>(sqe_map_->get());
+
+        std::byte* sq = sq_map_->get();
+        sq_head_ = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+        sq_mask_ = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+
+        std::byte* cq = single_mmap ? sq : cq_map_->get();
+        cq_head_ = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+        cq_mask_ = reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+
+        completer_ = std::thread([this]() { reap_loop(); });
+    }
+
+    static void fill_sqe(io_uring_sqe& sqe, Pending& p)
+    {
+        std::memset(&sqe, 0, sizeof(sqe));
+        const IoRequest& request = p.request;
+        const bool fixed = request.buffer_index >= 0;
+        if (request.op == IoRequest::Op::Read)
+        {
+            sqe.opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+        }
+        else
+        {
+            sqe.opcode = fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        }
+        sqe.fd = p.fd;
+        sqe.addr = reinterpret_cast<std::uint64_t>(request.data + p.done);
+        sqe.len = static_cast<std::uint32_t>(request.length - p.done);
+        sqe.off = request.offset + p.done;
+        sqe.buf_index = fixed ? static_cast<std::uint16_t>(request.buffer_index) : 0;
+        sqe.user_data = reinterpret_cast<std::uint64_t>(&p); // 完了したときに Pending を取り出す
+    }
+
+    // pending[i] から空いている SQE を埋められるだけ埋め、1回の io_uring_enter で渡す。
+    // 受け取られた分だけ i を進める。受け取られなかった SQE は取り消し、エラーなら -errno を返す。
+    // submit_mutex_ を持った状態で呼ぶ（SQPOLL を使わないので、SQ はこのスレッドが enter するまで読まれない）
+    int push(const std::vector<Pending*>& pending, std::size_t& i)
+    {
+        const unsigned tail = *sq_tail_;
+        const unsigned head = std::atomic_ref(*sq_head_).load(std::memory_order_acquire);
+        const unsigned space = sq_entries_ - (tail - head);
+        if (space == 0)
+        {
+            return -EBUSY; // 呼び出し側が完了を待ってからやり直す
+        }
+        unsigned queued = 0;
+        for (; i + queued < pending.size() && queued < space; ++queued)
+        {
+            const unsigned index = (tail + queued) & *sq_mask_;
+            fill_sqe(sqes_[index], *pending[i + queued]);
+            sq_array_[index] = index;
+        }
+        std::atomic_ref(*sq_tail_).store(tail + queued, std::memory_order_release);
+        const int ret = enter(queued, 0, 0);
+        const int error = ret < 0 ? -errno : 0;
+        const unsigned accepted = ret < 0 ? 0 : static_cast<unsigned>(ret);
+        i += accepted;
+        if (accepted < queued)
+        {
+            std::atomic_ref(*sq_tail_).store(tail + accepted, std::memory_order_release);
+            return error != 0 ? error : -EAGAIN;
+        }
+        return 0;
+    }
+
+    void fail(Pending* p, int error)
+    {
+        std::unique_ptr<Pending> owned(p);
+        if (owned->request.callback)
+        {
+            owned->request.callback(IoResult{ error });
+        }
+        on_complete_();
+    }
+
+    int enter(unsigned to_submit, unsigned min_complete, unsigned flags)
+    {
+        int ret;
+        do
+        {
+            ret = static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd_.get(), to_submit, min_complete, flags, nullptr, 0));
+        } while (ret < 0 && errno == EINTR);
+        return ret;
+    }
+
+    // 完了用スレッドが、途中までだった読み書きの残りを出し直す。
+    // submit() が SQ を使っているときや、一時的に受け取ってもらえないときは、次の回に回す
+    void resubmit(std::vector<Pending*>& retry)
+    {
+        std::unique_lock lock(submit_mutex_, std::try_to_lock);
+        if (!lock.owns_lock())
+        {
+            return;
+        }
+        std::size_t i = 0;
+        while (i < retry.size())
+        {
+            const int ret = push(retry, i);
+            if (ret == -EAGAIN || ret == -EBUSY)
+            {
+                break;
+            }
+            if (ret < 0)
+            {
+                for (; i < retry.size(); ++i)
+                {
+                    fail(retry[i], ret);
+                }
+            }
+        }
+        retry.erase(retry.begin(), retry.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+
+    // 完了用スレッド：CQ から結果を取り出してコールバックを呼ぶ
+    // SQE を書いたスレッドとの順序はカーネルを通して保証される（ThreadSanitizer はこれを追えず誤検知する）
+    void reap_loop()
+    {
+        std::vector<Pending*> retry;
+        for (;;)
+        {
+            if (!retry.empty())
+            {
+                resubmit(retry);
+            }
+            unsigned head = *cq_head_;
+            const unsigned tail = std::atomic_ref(*cq_tail_).load(std::memory_order_acquire);
+            if (head == tail)
+            {
+                if (retry.empty())
+                {
+                    enter(0, 1, IORING_ENTER_GETEVENTS);
+                }
+                else
+                {
+                    std::this_thread::yield(); // 出し直し待ちがあるので、眠り込まずにもう一度試す
+                }
+                continue;
+            }
+            bool stop = false;
+            std::vector<std::pair<Pending*, int>> finished;
+            for (; head != tail; ++head)
+            {
+                const io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+                if (cqe.user_data == 0)
+                {
+                    stop = true;
+                    continue;
+                }
+                auto* p = reinterpret_cast<Pending*>(cqe.user_data);
+                if (cqe.res == -EAGAIN || cqe.res == -EINTR)
+                {
+                    retry.push_back(p);
+                }
+                else if (cqe.res < 0)
+                {
+                    finished.emplace_back(p, cqe.res);
+                }
+                else
+                {
+                    // スレッドプール版と同じく、途中までなら続きを読み書きし、0 バイト（ファイルの終わり）で止める
+                    p->done += static_cast<std::size_t>(cqe.res);
+                    if (cqe.res > 0 && p->done < p->request.length)
+                    {
+                        retry.push_back(p);
+                    }
+                    else
+                    {
+                        finished.emplace_back(p, static_cast<int>(p->done));
+                    }
+                }
+            }
+            // 先に CQ を空けてから、コールバックを呼ぶ
+            std::atomic_ref(*cq_head_).store(head, std::memory_order_release);
+            for (const auto& [p, value] : finished)
+            {
+                std::unique_ptr<Pending> owned(p);
+                if (owned->request.callback)
+                {
+                    owned->request.callback(IoResult{ value });
+                }
+                on_complete_();
+            }
+            if (stop)
+            {
+                return;
+            }
+        }
+    }
+
+    UniqueFd              ring_fd_;
+    unsigned              sq_entries_;
+    std::function<void()> on_complete_;
+    std::mutex            submit_mutex_;
+    std::thread           completer_;
+
+    std::unique_ptr<Mapping> sq_map_;
+    std::unique_ptr<Mapping> cq_map_; // IORING_FEAT_SINGLE_MMAP なら使わない（sq_map_ と同じ領域）
+    std::unique_ptr<Mapping> sqe_map_;
+    io_uring_sqe*            sqes_ = nullptr;
+
+    unsigned*     sq_head_;
+    unsigned*     sq_tail_;
+    unsigned*     sq_mask_;
+    unsigned*     sq_array_;
+    unsigned*     cq_head_;
+    unsigned*     cq_tail_;
+    unsigned*     cq_mask_;
+    io_uring_cqe* cqes_;
+};
+
+// --- スレッドプールのバックエンド（io_uring が使えないとき） ---
+class ThreadPoolBackend : public IoBackend
+{
+public:
+    ThreadPoolBackend(unsigned threads, std::function<void()> on_complete)
+        : on_complete_(std::move(on_complete))
+    {
+        for (unsigned i = 0; i < threads; ++i)
+        {
+            workers_.emplace_back([this]() { work_loop(); });
+        }
+    }
+
+    ~ThreadPoolBackend() override
+    {
+        shutdown();
+    }
+
+    const char* name() const override { return "thread pool"; }
+
+    // pread / pwrite にはバッファの登録という仕組みがないので、何もしない
+    void register_buffers(std::span<const std::span<std::byte>>) override {}
+
+    void submit(int fd, std::vector<IoRequest>& requests) override
+    {
+        {
+            std::lock_guard lock(mutex_);
+            for (auto& r : requests)
+            {
+                jobs_.push_back({ fd, std::move(r) });
+            }
+        }
+        cv_.notify_all();
+    }
+
+    void shutdown() override
+    {
+        {
+            std::lock_guard lock(mutex_);
+            if (stopping_)
+            {
+                return;
+            }
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto& t : workers_)
+        {
+            t.join();
+        }
+    }
+
+private:
+    struct Job
+    {
+        int       fd;
+        IoRequest request;
+    };
+
+    void work_loop()
+    {
+        for (;;)
+        {
+            Job job;
+            {
+                std::unique_lock lock(mutex_);
+                cv_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+                if (jobs_.empty())
+                {
+                    return;
+                }
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+            }
+            const IoResult result = run(job.fd, job.request);
+            if (job.request.callback)
+            {
+                job.request.callback(result);
+            }
+            on_complete_();
+        }
+    }
+
+    // io_uring と同じく、途中までしか転送できなかったら続きを読み書きする
+    static IoResult run(int fd, const IoRequest& r)
+    {
+        std::size_t done = 0;
+        while (done < r.length)
+        {
+            const off_t offset = static_cast<off_t>(r.offset + done);
+            const ssize_t n = r.op == IoRequest::Op::Read
+                ? ::pread(fd, r.data + done, r.length - done, offset)
+                : ::pwrite(fd, r.data + done, r.length - done, offset);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return { -errno };
+            }
+            if (n == 0)
+            {
+                break; // ファイルの終わり
+            }
+            done += static_cast<std::size_t>(n);
+        }
+        return { static_cast<int>(done) };
+    }
+
+    std::function<void()>    on_complete_;
+    std::mutex               mutex_;
+    std::condition_variable  cv_;
+    std::deque<Job>          jobs_;
+    std::vector<std::thread> workers_;
+    bool                     stopping_ = false;
+};
+
+// --- RAII の非同期ファイルハンドル ---
+class AsyncFile
+{
+public:
+    enum class Mode
+    {
+        Read,
+        Write, // なければ作り、中身を空にする
+        ReadWrite,
+    };
+
+    enum class Backend
+    {
+        Auto, // io_uring を試し、だめならスレッドプール
+        Uring,
+        ThreadPool,
+    };
+
+    AsyncFile(const std::string& path, Mode mode, Backend backend = Backend::Auto)
+        : path_(path)
+    {
+        int flags = O_CLOEXEC;
+        switch (mode)
+        {
+        case Mode::Read:      flags |= O_RDONLY; break;
+        case Mode::Write:     flags |= O_WRONLY | O_CREAT | O_TRUNC; break;
+        case Mode::ReadWrite: flags |= O_RDWR | O_CREAT; break;
+        }
+        fd_ = UniqueFd(::open(path.c_str(), flags, 0644));
+        if (fd_.get() < 0)
+        {
+            throw std::runtime_error("ファイルを開けませんでした: " + path);
+        }
+
+        auto on_complete = [this]() { finish_one(); };
+        if (backend != Backend::ThreadPool)
+        {
+            backend_ = UringBackend::create(64, on_complete);
+        }
+        if (backend_ == nullptr)
+        {
+            if (backend == Backend::Uring)
+            {
+                throw std::runtime_error("io_uring を使えません");
+            }
+            backend_ = std::make_unique<ThreadPoolBackend>(2, on_complete);
+        }
+    }
+
+    // 発行済みの I/O をすべて待ってから閉じる
+    ~AsyncFile()
+    {
+        drain();
+        backend_.reset(); // fd_ はこの後、メンバのデストラクタが閉じる
+    }
+
+    AsyncFile(const AsyncFile&) = delete;
+    AsyncFile& operator=(const AsyncFile&) = delete;
+
+    const char*        backend_name() const { return backend_->name(); }
+    const std::string& path() const { return path_; }
+
+    // 何度も使うバッファを前もって登録する（最初の I/O の前に1回だけ）
+    void register_buffers(std::span<const std::span<std::byte>> buffers)
+    {
+        backend_->register_buffers(buffers);
+    }
+
+    // バッチの中身をまとめて発行する。ここでは完了を待たない
+    void submit(IoBatch& batch)
+    {
+        in_flight_.fetch_add(batch.size(), std::memory_order_relaxed);
+        backend_->submit(fd_.get(), batch.requests_);
+        batch.requests_.clear();
+    }
+
+    // 1件だけ発行し、結果を future で受け取る
+    std::future<IoResult> read(std::span<std::byte> buffer, std::size_t offset)
+    {
+        auto promise = std::make_shared<std::promise<IoResult>>();
+        auto future = promise->get_future();
+        IoBatch batch;
+        batch.read(buffer, offset, [promise](IoResult r) { promise->set_value(r); });
+        submit(batch);
+        return future;
+    }
+
+    std::future<IoResult> write(std::span<const std::byte> data, std::size_t offset)
+    {
+        auto promise = std::make_shared<std::promise<IoResult>>();
+        auto future = promise->get_future();
+        IoBatch batch;
+        batch.write(data, offset, [promise](IoResult r) { promise->set_value(r); });
+        submit(batch);
+        return future;
+    }
+
+    // 発行済みの I/O がすべて終わるまで待つ
+    void drain()
+    {
+        std::unique_lock lock(drain_mutex_);
+        drained_.wait(lock, [this]() { return in_flight_.load(std::memory_order_acquire) == 0; });
+    }
+
+    std::size_t in_flight() const { return in_flight_.load(std::memory_order_relaxed); }
+
+private:
+    void finish_one()
+    {
+        if (in_flight_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            std::lock_guard lock(drain_mutex_);
+            drained_.notify_all();
+        }
+    }
+
+    std::string                path_;
+    UniqueFd                   fd_;
+    std::unique_ptr<IoBackend> backend_;
+    std::atomic<std::size_t>   in_flight_{ 0 };
+    std::mutex                 drain_mutex_;
+    std::condition_variable    drained_;
+};
+
+// lesson17_6 の FileManager を、本当にファイルを扱うように書き直したもの
+class FileManager
+{
+public:
+    explicit FileManager(const std::string& name)
+        : file_(name, AsyncFile::Mode::ReadWrite)
+    {
+        std::cout << file_.path() << "を開きました (" << file_.backend_name() << ")" << std::endl;
+    }
+
+    ~FileManager()
+    {
+        // file_ のデストラクタが書き込みの完了を待ってから閉じる
+        std::cout << file_.path() << "を閉じます（未完了の I/O: " << file_.in_flight() << "件）" << std::endl;
+    }
+
+    AsyncFile& file() { return file_; }
+
+private:
+    AsyncFile file_;
+};
+
+std::span<const std::byte> as_bytes(const std::string& s)
+{
+    return std::as_bytes(std::span(s.data(), s.size()));
+}
+
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+    const std::string path = "save_data.txt";
+
+    // 1フレームで書き出すセーブデータ（スロットごとに 4KB）
+    constexpr int SLOTS = 32;
+    constexpr std::size_t SLOT_SIZE = 4096;
+    std::vector<std::string> slots;
+    for (int i = 0; i < SLOTS; ++i)
+    {
+        std::string text = "slot " + std::to_string(i) + ": 勇者 Lv" + std::to_string(10 + i) + "\n";
+        text.resize(SLOT_SIZE, '.');
+        slots.push_back(std::move(text));
+    }
+
+    {
+        FileManager manager(path);
+        AsyncFile& file = manager.file();
+
+        // --- バッチで書き込む：ゲームのスレッドは発行するだけ ---
+        std::atomic<int> written{ 0 };
+        IoBatch batch;
+        for (int i = 0; i < SLOTS; ++i)
+        {
+            batch.write(as_bytes(slots[i]), i * SLOT_SIZE, [&written](IoResult r)
+                {
+                    if (r.ok())
+                    {
+                        written += static_cast<int>(r.bytes());
+                    }
+                });
+        }
+        const auto start = Clock::now();
+        file.submit(batch);
+        const auto us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+        std::cout << SLOTS << "件の書き込みを発行: " << us << "us（この間に完了したのは "
+                  << written.load() << "バイト）" << std::endl;
+
+        file.drain();
+        std::cout << "書き込み完了: " << written.load() << "バイト" << std::endl;
+
+        // --- 登録済みバッファに読み込み、future で受け取る ---
+        std::vector<std::byte> buffer(SLOT_SIZE);
+        const std::span<std::byte> registered[] = { buffer };
+        file.register_buffers(registered);
+
+        std::promise<IoResult> promise;
+        auto future = promise.get_future();
+        IoBatch reads;
+        reads.read_fixed(0, buffer, 5 * SLOT_SIZE, [&promise](IoResult r) { promise.set_value(r); });
+        file.submit(reads);
+
+        // 待っている間もゲームの処理を進められる
+        const IoResult result = future.get();
+        const std::string head(reinterpret_cast<const char*>(buffer.data()), 20);
+        std::cout << "スロット5を読み込み: " << result.bytes() << "バイト \"" << head.substr(0, head.find('\n')) << "\"" << std::endl;
+
+        // 1件だけなら read / write が future を返す
+        std::string tail(8, '\0');
+        auto last = file.read(std::as_writable_bytes(std::span(tail.data(), tail.size())), SLOTS * SLOT_SIZE - 8);
+        std::cout << "末尾: " << last.get().bytes() << "バイト \"" << tail << "\"" << std::endl;
+
+        // ファイルの終わりをまたぐ読み込みは、途中までの続きを出し直し、0 バイトが返ったところで止まる
+        std::string over(16, '\0');
+        auto past_end = file.read(std::as_writable_bytes(std::span(over.data(), over.size())), SLOTS * SLOT_SIZE - 8);
+        std::cout << "終わりをまたいで16バイト: " << past_end.get().bytes() << "バイト" << std::endl;
+
+        // 書き込みを発行したままスコープを抜けても、デストラクタが完了を待つ
+        file.write(as_bytes(slots[0]), 0);
+    }
+
+    // スレッドプール版でも同じように使える
+    {
+        AsyncFile file(path, AsyncFile::Mode::Read, AsyncFile::Backend::ThreadPool);
+        std::string text(7, '\0');
+        auto f = file.read(std::as_writable_bytes(std::span(text.data(), text.size())), SLOT_SIZE);
+        std::cout << "\n" << file.backend_name() << " で読み込み: \"" << text.substr(0, f.get().bytes()) << "\"" << std::endl;
+    }
+
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,472 @@
+#include <chrono>
+#include <cmath>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#if defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+// --- 固定小数点の Vector2Fx と、毎ティックの状態ハッシュ ---
+// lesson18_1〜18_5 の Vector2 は float なので、コンパイラや最適化の設定によって
+// 計算結果の下位ビットが変わる（a * b + c が1命令の FMA にまとめられるかどうか、など）。
+// 全員が同じ入力から同じ計算をする「ロックステップ」の対戦やリプレイでは、
+// 1ビットの違いがそのうち大きなずれになる。
+// 整数だけで計算する固定小数点なら、どの環境でも結果はビット単位で同じになる。
+//
+//   Fx           … Q16.16（上位16ビットが整数部、下位16ビットが小数部）。±32768 まで、刻みは 1/65536
+//   Vector2Fx    … Vector2 と同じ演算子を持つ固定小数点版
+//   integrate    … 全員の位置と速度を1回で進め、同じループの中で状態のハッシュも計算する
+// ハッシュを毎ティック送り合えば、全状態を比べなくても、ずれたティックですぐに気づける
+
+struct Fx
+{
+    static constexpr int FRAC_BITS = 16;
+    static constexpr std::int32_t ONE = 1 << FRAC_BITS;
+
+    std::int32_t raw = 0;
+
+    static constexpr Fx from_raw(std::int32_t r) { return Fx{ r }; }
+    static constexpr Fx from_int(int v) { return Fx{ static_cast<std::int32_t>(v * ONE) }; }
+    // double からの変換はコンパイル時だけに限る（実行時の浮動小数点を計算に混ぜない）
+    static consteval Fx from_double(double v)
+    {
+        return Fx{ static_cast<std::int32_t>(v * ONE + (v < 0 ? -0.5 : 0.5)) };
+    }
+    // 表示用
+    double to_double() const { return static_cast<double>(raw) / ONE; }
+
+    // ±32768 を超えたときは 2^32 を法として折り返す（_mm256_add_epi32 と同じ）。
+    // int32_t のまま足すと桁あふれが未定義動作になり、最適化で結果が変わりうるので uint32_t で計算する
+    static constexpr std::int32_t wrap_add(std::int32_t a, std::int32_t b)
+    {
+        return static_cast<std::int32_t>(static_cast<std::uint32_t>(a) + static_cast<std::uint32_t>(b));
+    }
+    static constexpr std::int32_t wrap_sub(std::int32_t a, std::int32_t b)
+    {
+        return static_cast<std::int32_t>(static_cast<std::uint32_t>(a) - static_cast<std::uint32_t>(b));
+    }
+
+    constexpr Fx operator+(Fx o) const { return from_raw(wrap_add(raw, o.raw)); }
+    constexpr Fx operator-(Fx o) const { return from_raw(wrap_sub(raw, o.raw)); }
+    constexpr Fx operator-() const { return from_raw(wrap_sub(0, raw)); }
+    // 64ビットで掛けてから小数部の分だけ右にずらす（負の数は -∞ 方向に切り捨て）。
+    // 32ビットに入らない結果は下位32ビットが残る（C++20 の整数変換は 2^32 を法とする。SIMD 版と同じ）
+    constexpr Fx operator*(Fx o) const
+    {
+        return from_raw(static_cast<std::int32_t>((static_cast<std::int64_t>(raw) * o.raw) >> FRAC_BITS));
+    }
+    constexpr Fx operator/(Fx o) const
+    {
+        return from_raw(static_cast<std::int32_t>((static_cast<std::int64_t>(raw) << FRAC_BITS) / o.raw));
+    }
+    constexpr Fx& operator+=(Fx o) { raw = wrap_add(raw, o.raw); return *this; }
+    constexpr Fx& operator-=(Fx o) { raw = wrap_sub(raw, o.raw); return *this; }
+    constexpr Fx& operator*=(Fx o) { return *this = *this * o; }
+
+    constexpr auto operator<=>(const Fx&) const = default;
+
+    friend std::ostream& operator<<(std::ostream& os, Fx v)
+    {
+        os << v.to_double();
+        return os;
+    }
+};
+
+class Vector2Fx
+{
+public:
+    Fx x;
+    Fx y;
+
+    constexpr Vector2Fx() = default;
+    constexpr Vector2Fx(Fx x, Fx y) : x(x), y(y) {}
+
+    constexpr Vector2Fx operator+(const Vector2Fx& other) const { return Vector2Fx(x + other.x, y + other.y); }
+    constexpr Vector2Fx operator-(const Vector2Fx& other) const { return Vector2Fx(x - other.x, y - other.y); }
+    constexpr Vector2Fx operator*(Fx scalar) const { return Vector2Fx(x * scalar, y * scalar); }
+    friend constexpr Vector2Fx operator*(Fx scalar, const Vector2Fx& vec) { return vec * scalar; }
+
+    constexpr bool operator==(const Vector2Fx& other) const { return x == other.x && y == other.y; }
+    constexpr bool operator!=(const Vector2Fx& other) const { return !(*this == other); }
+
+    constexpr Vector2Fx& operator+=(const Vector2Fx& other)
+    {
+        x += other.x;
+        y += other.y;
+        return *this;
+    }
+
+    constexpr Vector2Fx& operator-=(const Vector2Fx& other)
+    {
+        x -= other.x;
+        y -= other.y;
+        return *this;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const Vector2Fx& vec)
+    {
+        os << "(" << vec.x << ", " << vec.y << ")";
+        return os;
+    }
+};
+
+// コンパイル時に計算しても結果は同じ
+static_assert((Vector2Fx(Fx::from_int(1), Fx::from_int(2)) + Vector2Fx(Fx::from_int(3), Fx::from_int(4))) * Fx::from_double(0.5)
+              == Vector2Fx(Fx::from_int(2), Fx::from_int(3)));
+
+// --- たくさんの物体（列ごとに配列を持つ） ---
+struct BodiesFx
+{
+    std::vector<std::int32_t> px, py, vx, vy; // Fx の raw をそのまま並べる
+
+    explicit BodiesFx(std::size_t n) : px(n), py(n), vx(n), vy(n) {}
+    std::size_t size() const { return px.size(); }
+    Vector2Fx position(std::size_t i) const { return { Fx::from_raw(px[i]), Fx::from_raw(py[i]) }; }
+};
+
+// 1体分のハッシュ。番号も混ぜるので、2体の状態が入れ替わっても別の値になる
+inline std::uint32_t body_hash(std::uint32_t i, std::uint32_t px, std::uint32_t py, std::uint32_t vx, std::uint32_t vy)
+{
+    std::uint32_t h = (px * 0x9E3779B1u) ^ (py * 0x85EBCA77u) ^ (vx * 0xC2B2AE3Du) ^ (vy * 0x27D4EB2Fu) ^ (i * 0x165667B1u);
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+
+// 全体のハッシュは1体ごとのハッシュの和（足す順番に関係なく同じ値になる）。
+// 1体だけ変わったときは、古い値を引いて新しい値を足せばよい
+class StateHash
+{
+public:
+    void add(std::uint32_t body) { sum_ += body; }
+    void remove(std::uint32_t body) { sum_ -= body; }
+    void replace(std::uint32_t old_body, std::uint32_t new_body) { sum_ += new_body - old_body; }
+    void reset(std::uint32_t sum) { sum_ = sum; }
+
+    // ティック番号も混ぜて、送り合う 64 ビットの値にする
+    std::uint64_t tick_hash(std::uint32_t tick) const
+    {
+        std::uint64_t x = (static_cast<std::uint64_t>(tick) << 32) | sum_;
+        x = (x ^ (x >> 33)) * 0xff51afd7ed558ccdULL;
+        x = (x ^ (x >> 33)) * 0xc4ceb9fe1a85ec53ULL;
+        return x ^ (x >> 33);
+    }
+
+private:
+    std::uint32_t sum_ = 0;
+};
+
+// 1体分を進める（SIMD 版の端数と、結果の確認に使う）
+// 読み込み → 計算 → 書き込みの順にまとめる。書いた直後に読み直すと、各配列の先頭のずれが
+// 4KiB の倍数のとき（大きな vector ではよくある）、読み込みが直前の書き込みを待ってしまう
+inline std::uint32_t integrate_one(BodiesFx& b, std::size_t i, Fx gravity_dt, Fx dt)
+{
+    const std::int32_t vx = b.vx[i];
+    const std::int32_t vy = Fx::wrap_add(b.vy[i], gravity_dt.raw);
+    const std::int32_t px = Fx::wrap_add(b.px[i], (Fx::from_raw(vx) * dt).raw);
+    const std::int32_t py = Fx::wrap_add(b.py[i], (Fx::from_raw(vy) * dt).raw);
+    b.vy[i] = vy;
+    b.px[i] = px;
+    b.py[i] = py;
+    return body_hash(static_cast<std::uint32_t>(i), px, py, vx, vy);
+}
+
+std::uint32_t integrate_scalar(BodiesFx& b, Fx gravity, Fx dt)
+{
+    const Fx gravity_dt = gravity * dt;
+    std::uint32_t sum = 0;
+    for (std::size_t i = 0; i < b.size(); ++i)
+    {
+        sum += integrate_one(b, i, gravity_dt, dt);
+    }
+    return sum;
+}
+
+#if defined(__AVX2__)
+namespace simd
+{
+    // 8個の Q16.16 の掛け算。_mm256_mul_epi32 は偶数番目の要素どうしを 64 ビットで掛けるので、
+    // 奇数番目は 32 ビットずらしてもう1回掛ける。
+    // 欲しいのは積の 16〜47 ビット目なので、偶数側は右に16、奇数側は左に16ずらして混ぜる
+    // （符号付きの右シフトでなくても、取り出す32ビットは同じになる）
+    inline __m256i mul_fx(__m256i a, __m256i b)
+    {
+        const __m256i even = _mm256_srli_epi64(_mm256_mul_epi32(a, b), Fx::FRAC_BITS);
+        const __m256i odd = _mm256_slli_epi64(_mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32)), 32 - Fx::FRAC_BITS);
+        return _mm256_blend_epi32(even, odd, 0b10101010);
+    }
+
+    inline __m256i mul32(__m256i a, std::uint32_t k)
+    {
+        return _mm256_mullo_epi32(a, _mm256_set1_epi32(static_cast<int>(k)));
+    }
+
+    // body_hash の8体分
+    inline __m256i body_hash(__m256i i, __m256i px, __m256i py, __m256i vx, __m256i vy)
+    {
+        __m256i h = _mm256_xor_si256(_mm256_xor_si256(mul32(px, 0x9E3779B1u), mul32(py, 0x85EBCA77u)),
+                                     _mm256_xor_si256(_mm256_xor_si256(mul32(vx, 0xC2B2AE3Du), mul32(vy, 0x27D4EB2Fu)), mul32(i, 0x165667B1u)));
+        h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+        h = mul32(h, 0x85EBCA6Bu);
+        h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 13));
+        h = mul32(h, 0xC2B2AE35u);
+        return _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+    }
+}
+#elif defined(__SSE4_1__)
+namespace simd
+{
+    // AVX2 がなくても SSE4.1 があれば、同じ計算を4個ずつ行える（_mm_mul_epi32 と _mm_mullo_epi32 は SSE4.1 から）。
+    // SSE2 だけだと符号付きの掛け算を組み立てる手間が増え、1体ずつの版より遅くなるので使わない
+    inline __m128i mul_fx(__m128i a, __m128i b)
+    {
+        const __m128i even = _mm_srli_epi64(_mm_mul_epi32(a, b), Fx::FRAC_BITS);
+        const __m128i odd = _mm_slli_epi64(_mm_mul_epi32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32)), 32 - Fx::FRAC_BITS);
+        return _mm_blend_epi16(even, odd, 0b11001100);
+    }
+
+    inline __m128i mul32(__m128i a, std::uint32_t k)
+    {
+        return _mm_mullo_epi32(a, _mm_set1_epi32(static_cast<int>(k)));
+    }
+
+    // body_hash の4体分
+    inline __m128i body_hash(__m128i i, __m128i px, __m128i py, __m128i vx, __m128i vy)
+    {
+        __m128i h = _mm_xor_si128(_mm_xor_si128(mul32(px, 0x9E3779B1u), mul32(py, 0x85EBCA77u)),
+                                  _mm_xor_si128(_mm_xor_si128(mul32(vx, 0xC2B2AE3Du), mul32(vy, 0x27D4EB2Fu)), mul32(i, 0x165667B1u)));
+        h = _mm_xor_si128(h, _mm_srli_epi32(h, 16));
+        h = mul32(h, 0x85EBCA6Bu);
+        h = _mm_xor_si128(h, _mm_srli_epi32(h, 13));
+        h = mul32(h, 0xC2B2AE35u);
+        return _mm_xor_si128(h, _mm_srli_epi32(h, 16));
+    }
+}
+#endif
+
+// 位置と速度を進め、新しい状態のハッシュの和を返す
+std::uint32_t integrate(BodiesFx& b, Fx gravity, Fx dt)
+{
+    const Fx gravity_dt = gravity * dt;
+    std::uint32_t sum = 0;
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i vgdt = _mm256_set1_epi32(gravity_dt.raw);
+    const __m256i vdt = _mm256_set1_epi32(dt.raw);
+    __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 8 <= b.size(); i += 8)
+    {
+        auto load = [](const std::int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); };
+        auto store = [](std::int32_t* p, __m256i v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); };
+        const __m256i vx = load(b.vx.data() + i);
+        const __m256i vy = _mm256_add_epi32(load(b.vy.data() + i), vgdt);
+        const __m256i px = _mm256_add_epi32(load(b.px.data() + i), simd::mul_fx(vx, vdt));
+        const __m256i py = _mm256_add_epi32(load(b.py.data() + i), simd::mul_fx(vy, vdt));
+        store(b.vy.data() + i, vy);
+        store(b.px.data() + i, px);
+        store(b.py.data() + i, py);
+        acc = _mm256_add_epi32(acc, simd::body_hash(index, px, py, vx, vy));
+        index = _mm256_add_epi32(index, _mm256_set1_epi32(8));
+    }
+    alignas(32) std::uint32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    for (std::uint32_t lane : lanes)
+    {
+        sum += lane;
+    }
+#elif defined(__SSE4_1__)
+    const __m128i vgdt = _mm_set1_epi32(gravity_dt.raw);
+    const __m128i vdt = _mm_set1_epi32(dt.raw);
+    __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 4 <= b.size(); i += 4)
+    {
+        auto load = [](const std::int32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); };
+        auto store = [](std::int32_t* p, __m128i v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); };
+        const __m128i vx = load(b.vx.data() + i);
+        const __m128i vy = _mm_add_epi32(load(b.vy.data() + i), vgdt);
+        const __m128i px = _mm_add_epi32(load(b.px.data() + i), simd::mul_fx(vx, vdt));
+        const __m128i py = _mm_add_epi32(load(b.py.data() + i), simd::mul_fx(vy, vdt));
+        store(b.vy.data() + i, vy);
+        store(b.px.data() + i, px);
+        store(b.py.data() + i, py);
+        acc = _mm_add_epi32(acc, simd::body_hash(index, px, py, vx, vy));
+        index = _mm_add_epi32(index, _mm_set1_epi32(4));
+    }
+    alignas(16) std::uint32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    for (std::uint32_t lane : lanes)
+    {
+        sum += lane;
+    }
+#endif
+    for (; i < b.size(); ++i)
+    {
+        sum += integrate_one(b, i, gravity_dt, dt);
+    }
+    return sum;
+}
+
+// --- 比較用：float の Vector2 と同じ計算 ---
+struct BodiesFloat
+{
+    std::vector<float> px, py, vx, vy;
+    explicit BodiesFloat(std::size_t n) : px(n), py(n), vx(n), vy(n) {}
+};
+
+void integrate_float(BodiesFloat& b, float gravity, float dt)
+{
+    const float gravity_dt = gravity * dt;
+    for (std::size_t i = 0; i < b.px.size(); ++i)
+    {
+        b.vy[i] += gravity_dt;
+        b.px[i] += b.vx[i] * dt;
+        b.py[i] += b.vy[i] * dt;
+    }
+}
+
+// 同じ初期状態を作る（値はすべて整数から作るので、どの環境でも同じ）
+BodiesFx make_bodies(std::size_t n)
+{
+    BodiesFx b(n);
+    std::uint32_t seed = 12345;
+    auto next = [&seed] { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        b.px[i] = static_cast<std::int32_t>(next() % (1000u << Fx::FRAC_BITS));
+        b.py[i] = static_cast<std::int32_t>(next() % (1000u << Fx::FRAC_BITS));
+        b.vx[i] = static_cast<std::int32_t>(next() % (20u << Fx::FRAC_BITS)) - (10 << Fx::FRAC_BITS);
+        b.vy[i] = static_cast<std::int32_t>(next() % (20u << Fx::FRAC_BITS)) - (10 << Fx::FRAC_BITS);
+    }
+    return b;
+}
+
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+    constexpr Fx GRAVITY = Fx::from_double(-9.8);
+    constexpr Fx DT = Fx::from_double(1.0 / 60.0); // 1092/65536 に丸められるので、float の結果とは少しずつ離れていく
+
+    // --- lesson18_2 と同じ使い方 ---
+    Vector2Fx pos(Fx::from_int(10), Fx::from_int(20));
+    const Vector2Fx velocity(Fx::from_double(1.5), Fx::from_double(2.5));
+    pos += velocity * DT;
+    std::cout << "位置: " << pos << " / 速度: " << velocity << "\n";
+
+    // float は書き方（FMA を使うかどうか）で結果のビットが変わることがある
+    volatile float a = 0.1f, b = 3.3f, c = -0.33f;
+    const float separate = a * b + c;
+    const float fused = std::fma(a, b, c);
+    std::cout << "float の a*b+c: " << separate << " / FMA: " << fused
+              << (std::memcmp(&separate, &fused, sizeof(float)) == 0 ? "（同じ）" : "（違う）") << "\n\n";
+
+    // --- SIMD 版と1体ずつの版がビット単位で一致するか ---
+    constexpr std::size_t BODIES = 1'000'003;
+    constexpr int TICKS = 200;
+    {
+        BodiesFx s = make_bodies(BODIES);
+        BodiesFx v = make_bodies(BODIES);
+        // 先頭の 16 体は +32768 の端のすぐ手前から速く動かし、折り返しても両方が同じになるか確かめる
+        for (BodiesFx* b : { &s, &v })
+        {
+            for (std::size_t i = 0; i < 16; ++i)
+            {
+                b->px[i] = INT32_MAX - static_cast<std::int32_t>(i);
+                b->vx[i] = Fx::from_int(30000).raw;
+                b->vy[i] = INT32_MIN + static_cast<std::int32_t>(i);
+            }
+        }
+        bool same = true;
+        for (int t = 0; t < 10; ++t)
+        {
+            same &= integrate_scalar(s, GRAVITY, DT) == integrate(v, GRAVITY, DT);
+        }
+        same &= s.px == v.px && s.py == v.py && s.vx == v.vx && s.vy == v.vy;
+        std::cout << "SIMD 版と1体ずつの版: " << (same ? "一致" : "不一致!") << "\n";
+    }
+
+    // --- 速さ：float / 固定小数点（1体ずつ）/ 固定小数点（SIMD、ハッシュ込み） ---
+    BodiesFloat fb(BODIES);
+    {
+        const BodiesFx init = make_bodies(BODIES);
+        for (std::size_t i = 0; i < BODIES; ++i)
+        {
+            fb.px[i] = static_cast<float>(Fx::from_raw(init.px[i]).to_double());
+            fb.py[i] = static_cast<float>(Fx::from_raw(init.py[i]).to_double());
+            fb.vx[i] = static_cast<float>(Fx::from_raw(init.vx[i]).to_double());
+            fb.vy[i] = static_cast<float>(Fx::from_raw(init.vy[i]).to_double());
+        }
+    }
+    auto start = Clock::now();
+    for (int t = 0; t < TICKS; ++t)
+    {
+        integrate_float(fb, -9.8f, 1.0f / 60.0f);
+    }
+    const auto float_ms = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+
+    // ハッシュを使わないと、インライン展開されたときにハッシュの計算ごと消されてしまうので足し込んでおく
+    std::uint32_t hash_sink = 0;
+    BodiesFx scalar = make_bodies(BODIES);
+    start = Clock::now();
+    for (int t = 0; t < TICKS; ++t)
+    {
+        hash_sink += integrate_scalar(scalar, GRAVITY, DT);
+    }
+    const auto scalar_ms = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+
+    BodiesFx fast = make_bodies(BODIES);
+    start = Clock::now();
+    for (int t = 0; t < TICKS; ++t)
+    {
+        hash_sink -= integrate(fast, GRAVITY, DT);
+    }
+    const auto fast_ms = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+
+    std::cout << BODIES << "体 x " << TICKS << "ティック\n";
+    std::cout << "  float:                  " << float_ms << "ms（ハッシュなし）\n";
+    std::cout << "  固定小数点（1体ずつ）:  " << scalar_ms << "ms（ハッシュ込み）\n";
+#if defined(__AVX2__)
+    std::cout << "  固定小数点（AVX2）:     " << fast_ms << "ms（ハッシュ込み）\n";
+#elif defined(__SSE4_1__)
+    std::cout << "  固定小数点（SSE4.1）:   " << fast_ms << "ms（ハッシュ込み）\n";
+#else
+    std::cout << "  固定小数点:             " << fast_ms << "ms（ハッシュ込み、SIMD なし）\n";
+#endif
+    std::cout << "  1体ずつと SIMD のハッシュの差: " << hash_sink << "（0 なら同じ状態）\n";
+    std::cout << "  0番の位置: " << fast.position(0) << " / float: (" << fb.px[0] << ", " << fb.py[0] << ")\n\n";
+
+    // --- ずれの検出：2台が同じシミュレーションを進め、ハッシュを送り合う ---
+    // 片方だけ、120ティック目に1体の速度が最下位の1ビットだけずれる
+    BodiesFx peer_a = make_bodies(100'000);
+    BodiesFx peer_b = make_bodies(100'000);
+    StateHash hash_a, hash_b;
+    for (std::uint32_t tick = 0; tick < 200; ++tick)
+    {
+        if (tick == 120)
+        {
+            const std::uint32_t i = 54321;
+            const std::uint32_t old_body = body_hash(i, peer_b.px[i], peer_b.py[i], peer_b.vx[i], peer_b.vy[i]);
+            peer_b.vx[i] += 1;
+            // 1体だけの変更は差分でハッシュを直せる（どうせ次の integrate で全体を計算し直すが、例として）
+            hash_b.replace(old_body, body_hash(i, peer_b.px[i], peer_b.py[i], peer_b.vx[i], peer_b.vy[i]));
+        }
+        hash_a.reset(integrate(peer_a, GRAVITY, DT));
+        hash_b.reset(integrate(peer_b, GRAVITY, DT));
+        if (hash_a.tick_hash(tick) != hash_b.tick_hash(tick))
+        {
+            std::cout << "ティック " << tick << " でずれを検出: " << std::hex << hash_a.tick_hash(tick)
+                      << " != " << hash_b.tick_hash(tick) << std::dec << "\n";
+            break;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "lesson19_7.hpp"
+
+// --- std::cout / std::endl の代わりに非同期ロガーを使う ---
+// lesson19_1 の Enemy::takeDamage は、1回ごとに cout で整形して endl で flush していた。
+// ここでは同じ処理を LOG_INFO に置き換え、呼び出し側のスレッドにかかる時間を比べる
+
+class Enemy
+{
+public:
+    std::string name;
+    int hp;
+
+    Enemy(std::string n, int h) : name(n), hp(h)
+    {
+        LOG_INFO("{}が出現! HP:{}", name, hp);
+    }
+
+    // lesson21 のように、デストラクタで倒したことを記録する
+    virtual ~Enemy()
+    {
+        LOG_INFO("{}を倒した!", name);
+    }
+
+    void takeDamage(int damage)
+    {
+        hp -= damage;
+        LOG_INFO("{}に{}ダメージ! 残りHP:{}", name, damage, hp);
+        // Debug レベルは既定ではコンパイルされない（引数の計算も消える）
+        LOG_DEBUG("  内部状態: hp={} ratio={}", hp, hp / 50.0);
+    }
+
+    // 比較用：lesson19_1 と同じ書き方
+    void takeDamageCout(std::ostream& os, int damage)
+    {
+        hp -= damage;
+        os << name << "に" << damage << "ダメージ! 残りHP:" << hp << std::endl;
+    }
+};
+
+class Slime : public Enemy
+{
+public:
+    Slime() : Enemy("スライム", 50)
+    {
+        LOG_INFO("スライムは分裂できる!");
+    }
+};
+
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+    constexpr int FRAMES = 100;
+    constexpr int HITS_PER_FRAME = 500;
+
+    std::FILE* log_file = std::fopen("combat_fast.log", "w");
+    fastlog::Logger::instance().set_output(log_file);
+    // 計測では 5万件（1件 64 バイト前後）を一気に書くので、書き出しを待たずに全部入る大きさにする。
+    // 小さいままだと大半が捨てられ、「捨てる処理」の速さを測ることになる
+    fastlog::Logger::instance().set_buffer_capacity(8 << 20);
+
+    {
+        Slime slime;
+        slime.takeDamage(20);
+
+        // lesson22_2 の take_damage ラムダも同じように書ける
+        int enemy_hp = 200;
+        auto take_damage = [&](int dmg)
+            {
+                enemy_hp -= dmg;
+                LOG_INFO("敵HP: {}", enemy_hp);
+            };
+        take_damage(50);
+        take_damage(80);
+    }
+
+    // --- 比較：cout + endl ---
+    std::ofstream cout_file("combat_cout.log");
+    Enemy target("ゴーレム", 1000000);
+    auto start = Clock::now();
+    for (int frame = 0; frame < FRAMES; ++frame)
+    {
+        for (int i = 0; i < HITS_PER_FRAME; ++i)
+        {
+            target.takeDamageCout(cout_file, 1 + i % 7);
+        }
+    }
+    const auto cout_us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+    // --- 非同期ロガー ---
+    start = Clock::now();
+    for (int frame = 0; frame < FRAMES; ++frame)
+    {
+        for (int i = 0; i < HITS_PER_FRAME; ++i)
+        {
+            target.takeDamage(1 + i % 7);
+        }
+    }
+    const auto fast_us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    fastlog::Logger::instance().flush(); // ファイルに書き終わるまでの時間も見ておく
+    const auto fast_flushed_us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+    // 別のスレッドからも、そのスレッド専用のバッファに書く
+    std::thread worker([]()
+        {
+            auto boss = std::make_unique<Enemy>("ドラゴン", 500);
+            boss->takeDamage(120);
+        });
+    worker.join();
+
+    fastlog::Logger::instance().flush(); // ここまでのログをすべて書き出す
+
+    std::cout << FRAMES * HITS_PER_FRAME << "回の takeDamage（呼び出し側の時間）" << std::endl;
+    std::cout << "cout + endl: " << cout_us << "us" << std::endl;
+    std::cout << "LOG_INFO:    " << fast_us << "us（書き出し完了まで " << fast_flushed_us << "us）" << std::endl;
+
+    // 捨てたログがあると比較にならない
+    const std::uint64_t dropped = fastlog::Logger::instance().dropped();
+    std::cout << "捨てたログ:  " << dropped << "件" << std::endl;
+    if (dropped != 0)
+    {
+        std::cout << "⚠️ バッファが足りません。set_buffer_capacity を大きくしてください" << std::endl;
+    }
+
+    // 出力の先頭を見てみる
+    std::cout << "\n--- combat_fast.log の先頭 ---" << std::endl;
+    std::ifstream in("combat_fast.log");
+    std::string line;
+    for (int i = 0; i < 6 && std::getline(in, line); ++i)
+    {
+        std::cout << line << std::endl;
+    }
+
+    fastlog::Logger::instance().shutdown();
+    std::fclose(log_file);
+    std::remove("combat_fast.log");
+    std::remove("combat_cout.log");
+    return dropped == 0 ? 0 : 1;
+}
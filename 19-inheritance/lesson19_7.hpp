@@ -0,0 +1,506 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// --- 非同期のバイナリロガー ---
+// std::cout << ... << std::endl は、呼んだスレッドで文字列に整形し、endl のたびに flush する。
+// 戦闘の計算よりログのほうが重い、ということがよく起きる。
+//
+// このロガーは、呼び出し側では「書式文字列の場所（コンパイル時に決まるポインタ）」と
+// 引数の生のバイト列をスレッドごとのリングバッファに書くだけにする。
+// 整形とファイルへの書き込みはバックグラウンドのスレッドがまとめて行う。
+//
+//   LOG_INFO("{}に{}ダメージ! 残りHP:{}", name, damage, hp);
+//
+// 書式の {} は引数で順に置き換える。使える引数は整数・浮動小数点数・bool・文字・文字列。
+// LOG_MIN_LEVEL より低いレベルのログは if constexpr で消え、引数も評価されない。
+//   -DLOG_MIN_LEVEL=2 … Warn 以上だけ残す
+//
+// バッファがいっぱいのときは待たずに捨て、捨てた件数を最後に報告する
+
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO  1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_ERROR 3
+
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL LOG_LEVEL_INFO
+#endif
+
+namespace fastlog
+{
+    enum class Level : std::uint8_t
+    {
+        Debug = LOG_LEVEL_DEBUG,
+        Info  = LOG_LEVEL_INFO,
+        Warn  = LOG_LEVEL_WARN,
+        Error = LOG_LEVEL_ERROR,
+    };
+
+    inline const char* level_name(Level level)
+    {
+        switch (level)
+        {
+        case Level::Debug: return "DEBUG";
+        case Level::Info:  return "INFO ";
+        case Level::Warn:  return "WARN ";
+        case Level::Error: return "ERROR";
+        }
+        return "?";
+    }
+
+    // 呼び出し箇所ごとに1つだけ静的に作られる情報。そのアドレスが書式の ID になる
+    struct Site
+    {
+        Level       level;
+        const char* format;
+        const char* file;
+        int         line;
+    };
+
+    // --- 引数のエンコード / デコード ---
+    // 文字列は長さ + 中身をコピーする（ポインタだけ渡すと、整形する頃には消えているかもしれない）
+    template<typename T>
+    constexpr bool is_string_v = std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>
+                              || std::is_same_v<T, const char*> || std::is_same_v<T, char*>;
+
+    template<typename T>
+    using arg_t = std::decay_t<T>;
+
+    template<typename T>
+    std::size_t encoded_size(const T& value)
+    {
+        if constexpr (is_string_v<T>)
+        {
+            return sizeof(std::uint32_t) + std::string_view(value).size();
+        }
+        else
+        {
+            static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "ログに渡せない型です");
+            return sizeof(T);
+        }
+    }
+
+    template<typename T>
+    std::byte* encode(std::byte* out, const T& value)
+    {
+        if constexpr (is_string_v<T>)
+        {
+            const std::string_view s(value);
+            const auto n = static_cast<std::uint32_t>(s.size());
+            std::memcpy(out, &n, sizeof(n));
+            std::memcpy(out + sizeof(n), s.data(), n);
+            return out + sizeof(n) + n;
+        }
+        else
+        {
+            std::memcpy(out, &value, sizeof(T));
+            return out + sizeof(T);
+        }
+    }
+
+    template<typename T>
+    void append_value(std::string& out, const std::byte*& in)
+    {
+        if constexpr (is_string_v<T>)
+        {
+            std::uint32_t n;
+            std::memcpy(&n, in, sizeof(n));
+            out.append(reinterpret_cast<const char*>(in + sizeof(n)), n);
+            in += sizeof(n) + n;
+        }
+        else
+        {
+            T value;
+            std::memcpy(&value, in, sizeof(T));
+            in += sizeof(T);
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                out += value ? "true" : "false";
+            }
+            else if constexpr (std::is_same_v<T, char>)
+            {
+                out += value;
+            }
+            else if constexpr (std::is_enum_v<T>)
+            {
+                out += std::to_string(static_cast<std::underlying_type_t<T>>(value));
+            }
+            else
+            {
+                out += std::to_string(value);
+            }
+        }
+    }
+
+    // format の {} を1つずつ引数で置き換える
+    template<typename... Args>
+    void decode(std::string& out, const char* format, const std::byte* in)
+    {
+        const char* p = format;
+        [[maybe_unused]] auto next_arg = [&](auto tag)
+            {
+                using T = typename decltype(tag)::type;
+                while (*p != '\0' && !(p[0] == '{' && p[1] == '}'))
+                {
+                    out += *p++;
+                }
+                if (*p != '\0')
+                {
+                    p += 2;
+                }
+                append_value<T>(out, in);
+            };
+        (next_arg(std::type_identity<Args>{}), ...);
+        out += p; // 残りの文字
+    }
+
+    using Decoder = void (*)(std::string&, const char*, const std::byte*);
+
+    struct alignas(8) RecordHeader
+    {
+        const Site*   site;      // nullptr ならリングの終わりまでの詰め物
+        Decoder       decoder;
+        std::int64_t  timestamp_ns;
+        std::uint32_t size;      // ヘッダを含む大きさ（RECORD_ALIGN の倍数）
+        std::uint32_t reserved;
+    };
+
+    // 記録の大きさをヘッダの倍数にそろえると、リングの末尾の余りにも必ず詰め物のヘッダが入る
+    constexpr std::size_t RECORD_ALIGN = sizeof(RecordHeader);
+
+    // --- スレッドごとのリングバッファ（書くのは持ち主のスレッド、読むのはバックグラウンドだけ） ---
+    class ThreadBuffer
+    {
+    public:
+        // capacity は 2 のべき乗にする
+        ThreadBuffer(std::uint32_t thread_index, std::size_t capacity)
+            : data_(new std::byte[capacity]), capacity_(capacity), thread_index_(thread_index)
+        {
+        }
+
+        // 書き込む場所を確保する。入りきらなければ nullptr
+        std::byte* reserve(std::size_t size)
+        {
+            const std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+            std::size_t offset = tail & (capacity_ - 1);
+            std::uint64_t needed = size;
+            const std::size_t to_end = capacity_ - offset;
+            if (size > capacity_)
+            {
+                ++dropped_;
+                return nullptr;
+            }
+            if (to_end < size)
+            {
+                needed += to_end; // 末尾に詰め物をして先頭から書く
+            }
+            if (tail + needed - cached_head_ > capacity_)
+            {
+                cached_head_ = head_.load(std::memory_order_acquire);
+                if (tail + needed - cached_head_ > capacity_)
+                {
+                    ++dropped_;
+                    return nullptr;
+                }
+            }
+            if (to_end < size)
+            {
+                auto* pad = reinterpret_cast<RecordHeader*>(data_.get() + offset);
+                pad->site = nullptr;
+                pad->size = static_cast<std::uint32_t>(to_end);
+                offset = 0;
+            }
+            pending_ = needed;
+            return data_.get() + offset;
+        }
+
+        void commit()
+        {
+            tail_.store(tail_.load(std::memory_order_relaxed) + pending_, std::memory_order_release);
+        }
+
+        // 溜まっている記録をすべて整形して out に足す
+        std::size_t consume(std::string& out)
+        {
+            std::uint64_t head = head_.load(std::memory_order_relaxed);
+            const std::uint64_t tail = tail_.load(std::memory_order_acquire);
+            std::size_t count = 0;
+            while (head != tail)
+            {
+                const auto* record = reinterpret_cast<const RecordHeader*>(data_.get() + (head & (capacity_ - 1)));
+                if (record->site != nullptr)
+                {
+                    format_record(out, *record);
+                    ++count;
+                }
+                head += record->size;
+            }
+            head_.store(head, std::memory_order_release);
+            return count;
+        }
+
+        std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    private:
+        void format_record(std::string& out, const RecordHeader& r) const
+        {
+            char prefix[64];
+            std::snprintf(prefix, sizeof(prefix), "%10.3fms [%s] T%u ",
+                          static_cast<double>(r.timestamp_ns) / 1e6, level_name(r.site->level), thread_index_);
+            out += prefix;
+            r.decoder(out, r.site->format, reinterpret_cast<const std::byte*>(&r + 1));
+            out += '\n';
+        }
+
+        std::unique_ptr<std::byte[]> data_;
+        std::size_t                  capacity_;
+        std::uint32_t                thread_index_;
+        alignas(64) std::atomic<std::uint64_t> tail_{ 0 };
+        std::uint64_t                cached_head_ = 0;
+        std::uint64_t                pending_ = 0;
+        std::atomic<std::uint64_t>   dropped_{ 0 }; // 持ち主だけが増やす
+        alignas(64) std::atomic<std::uint64_t> head_{ 0 };
+    };
+
+    // --- バックグラウンドで整形・書き込みをするロガー ---
+    class Logger
+    {
+    public:
+        static Logger& instance()
+        {
+            static Logger logger;
+            return logger;
+        }
+
+        // 出力先を変える。それまでに書かれたログは、どちらに出るかわからないので先に flush() しておく
+        void set_output(std::FILE* file)
+        {
+            std::lock_guard lock(mutex_);
+            output_ = file;
+        }
+
+        // スレッドごとのバッファの大きさ（2 のべき乗に切り上げる）。
+        // そのスレッドが最初にログを書く前に呼ぶ。書き出しより速く書く時間が続くなら、その間のぶんが入る大きさにする
+        void set_buffer_capacity(std::size_t bytes)
+        {
+            std::lock_guard lock(mutex_);
+            std::size_t capacity = 4096;
+            while (capacity < bytes)
+            {
+                capacity <<= 1;
+            }
+            buffer_capacity_ = capacity;
+        }
+
+        // バッファがいっぱいで捨てた件数（全スレッドの合計）
+        std::uint64_t dropped()
+        {
+            std::lock_guard lock(mutex_);
+            std::uint64_t dropped = 0;
+            for (const auto& b : buffers_)
+            {
+                dropped += b->dropped();
+            }
+            return dropped;
+        }
+
+        std::chrono::steady_clock::time_point start_time() const { return start_; }
+
+        ThreadBuffer& local_buffer()
+        {
+            thread_local ThreadBuffer* buffer = register_thread();
+            return *buffer;
+        }
+
+        // ここまでに書かれたログがすべて出力されるまで待つ
+        void flush()
+        {
+            std::unique_lock lock(mutex_);
+            if (stopping_)
+            {
+                return; // shutdown() の後は書き出すスレッドがいない（最後の書き出しは shutdown() が済ませている）
+            }
+            const std::uint64_t target = ++flush_requested_;
+            wake_.notify_one();
+            flushed_.wait(lock, [&]() { return flush_done_ >= target; });
+        }
+
+        void shutdown()
+        {
+            {
+                std::lock_guard lock(mutex_);
+                if (stopping_)
+                {
+                    return;
+                }
+                stopping_ = true;
+            }
+            wake_.notify_one();
+            worker_.join();
+        }
+
+        ~Logger()
+        {
+            shutdown();
+        }
+
+    private:
+        Logger() : start_(std::chrono::steady_clock::now())
+        {
+            worker_ = std::thread([this]() { run(); });
+        }
+
+        ThreadBuffer* register_thread()
+        {
+            std::lock_guard lock(mutex_);
+            buffers_.push_back(std::make_unique<ThreadBuffer>(static_cast<std::uint32_t>(buffers_.size()), buffer_capacity_));
+            return buffers_.back().get();
+        }
+
+        // 全スレッドのバッファを順に読み、整形した結果を1回の fwrite で書き出す
+        std::size_t drain_all(std::string& batch)
+        {
+            std::vector<ThreadBuffer*> buffers;
+            std::FILE* output;
+            {
+                std::lock_guard lock(mutex_);
+                for (const auto& b : buffers_)
+                {
+                    buffers.push_back(b.get());
+                }
+                output = output_;
+            }
+            std::size_t count = 0;
+            for (ThreadBuffer* b : buffers)
+            {
+                count += b->consume(batch);
+            }
+            if (!batch.empty())
+            {
+                std::fwrite(batch.data(), 1, batch.size(), output);
+                std::fflush(output);
+                batch.clear();
+            }
+            return count;
+        }
+
+        void run()
+        {
+            std::string batch;
+            batch.reserve(1 << 16);
+            for (;;)
+            {
+                std::uint64_t flush_target;
+                bool stopping;
+                {
+                    std::unique_lock lock(mutex_);
+                    // ログが無くても 1ms ごとに見に行く（書く側は起こす手間をかけない）
+                    wake_.wait_for(lock, std::chrono::milliseconds(1),
+                                   [this]() { return stopping_ || flush_requested_ > flush_done_; });
+                    flush_target = flush_requested_;
+                    stopping = stopping_;
+                }
+
+                drain_all(batch);
+
+                {
+                    std::lock_guard lock(mutex_);
+                    flush_done_ = flush_target;
+                }
+                flushed_.notify_all();
+
+                if (stopping)
+                {
+                    report_dropped();
+                    return;
+                }
+            }
+        }
+
+        void report_dropped()
+        {
+            std::lock_guard lock(mutex_);
+            std::uint64_t dropped = 0;
+            for (const auto& b : buffers_)
+            {
+                dropped += b->dropped();
+            }
+            if (dropped > 0)
+            {
+                std::fprintf(output_, "[fastlog] バッファがいっぱいで %llu 件のログを捨てました\n",
+                             static_cast<unsigned long long>(dropped));
+                std::fflush(output_);
+            }
+        }
+
+        std::chrono::steady_clock::time_point      start_;
+        std::FILE*                                 output_ = stdout;        // mutex_ で守る
+        std::size_t                                buffer_capacity_ = 1 << 20; // 1MB
+        std::mutex                                 mutex_;
+        std::condition_variable                    wake_;
+        std::condition_variable                    flushed_;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+        std::uint64_t                              flush_requested_ = 0;
+        std::uint64_t                              flush_done_ = 0;
+        bool                                       stopping_ = false;
+        std::thread                                worker_;
+    };
+
+    inline std::int64_t now_ns()
+    {
+        static const auto start = Logger::instance().start_time();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // 呼び出し側の処理：ヘッダと引数のバイト列をリングに書くだけ
+    template<typename... Args>
+    void write(const Site& site, const Args&... args)
+    {
+        const std::size_t payload = (std::size_t{ 0 } + ... + encoded_size<arg_t<Args>>(args));
+        const std::size_t size = (sizeof(RecordHeader) + payload + RECORD_ALIGN - 1) / RECORD_ALIGN * RECORD_ALIGN;
+
+        ThreadBuffer& buffer = Logger::instance().local_buffer();
+        std::byte* out = buffer.reserve(size);
+        if (out == nullptr)
+        {
+            return;
+        }
+        auto* header = reinterpret_cast<RecordHeader*>(out);
+        header->site = &site;
+        header->decoder = &decode<arg_t<Args>...>;
+        header->timestamp_ns = now_ns();
+        header->size = static_cast<std::uint32_t>(size);
+        [[maybe_unused]] std::byte* p = out + sizeof(RecordHeader);
+        ((p = encode<arg_t<Args>>(p, args)), ...);
+        buffer.commit();
+    }
+}
+
+#define FASTLOG_AT(level_value, level_enum, fmt, ...)                                        \
+    do                                                                                       \
+    {                                                                                        \
+        if constexpr ((level_value) >= LOG_MIN_LEVEL)                                        \
+        {                                                                                    \
+            static constexpr ::fastlog::Site fastlog_site_{ level_enum, fmt, __FILE__, __LINE__ }; \
+            ::fastlog::write(fastlog_site_ __VA_OPT__(, ) __VA_ARGS__);                      \
+        }                                                                                    \
+    } while (0)
+
+#define LOG_DEBUG(fmt, ...) FASTLOG_AT(LOG_LEVEL_DEBUG, ::fastlog::Level::Debug, fmt __VA_OPT__(, ) __VA_ARGS__)
+#define LOG_INFO(fmt, ...)  FASTLOG_AT(LOG_LEVEL_INFO, ::fastlog::Level::Info, fmt __VA_OPT__(, ) __VA_ARGS__)
+#define LOG_WARN(fmt, ...)  FASTLOG_AT(LOG_LEVEL_WARN, ::fastlog::Level::Warn, fmt __VA_OPT__(, ) __VA_ARGS__)
+#define LOG_ERROR(fmt, ...) FASTLOG_AT(LOG_LEVEL_ERROR, ::fastlog::Level::Error, fmt __VA_OPT__(, ) __VA_ARGS__)
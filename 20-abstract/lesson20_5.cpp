@@ -0,0 +1,419 @@
+#include <algorithm>
+#include <barrier>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+// --- 攻撃を全コアで動かすための「ダメージ集計」段階 ---
+// lesson20_3 の takeDamage() は呼ばれたその場で hp を減らす。
+// 攻撃する側を複数のスレッドで動かすと、同じ相手の hp を同時に書き換えて値が壊れる。
+// そこで1ティックの戦闘を3段階に分ける。
+//   1. 攻撃：各スレッドは自分のバッファに (相手, ダメージ量) のイベントを書くだけ。hp は読むだけ
+//   2. 仕分け：イベントを相手の番号の範囲（シャード）ごとに並べ直す（数え上げソート）
+//   3. 集計と適用：シャードごとに合計し、相手1体につき takeDamage を1回だけ呼ぶ。
+//      シャードは相手の範囲が重ならないので、並列に動かしても同じ hp を触らない
+// 倒れた相手は番号順に並べて返すので、onDeath などの処理は1体1回・毎回同じ順番で呼ばれる。
+// スレッド数を変えても結果は同じになる（最後に確かめる）
+
+// lesson20_3 の IDamageable に「倒れたか」と「倒れたときの処理」を足したもの
+class IDamageable
+{
+public:
+    virtual void takeDamage(int damage) = 0;
+    virtual bool isDead() const = 0;
+    virtual void onDeath(std::uint32_t killer) = 0;
+    virtual ~IDamageable() {}
+};
+
+struct DamageEvent
+{
+    std::uint32_t target;
+    std::uint32_t source;
+    std::int32_t  amount;
+};
+
+// 倒れた相手と、いちばん多くダメージを与えた攻撃者（同じなら番号の小さい方）
+struct Death
+{
+    std::uint32_t target;
+    std::uint32_t killer;
+};
+
+// 範囲を決まった数のスレッドで分担して処理するワーカー。
+// resolve は1ティックに何度も並列の段階を通るので、スレッドは最初に1回だけ作り、
+// 呼ばれるたびに barrier で「開始」と「終了」をそろえる（lesson25_5 の LevelWorkers と同じ形）
+class RangeWorkers
+{
+public:
+    explicit RangeWorkers(unsigned threads) : start_(threads), done_(threads)
+    {
+        for (unsigned t = 1; t < threads; ++t)
+        {
+            workers_.emplace_back([this, t]()
+                {
+                    for (;;)
+                    {
+                        start_.arrive_and_wait();
+                        if (stopping_)
+                        {
+                            return;
+                        }
+                        job_(t);
+                        done_.arrive_and_wait();
+                    }
+                });
+        }
+    }
+
+    ~RangeWorkers()
+    {
+        stopping_ = true; // barrier を通るので、ワーカーからも見える
+        start_.arrive_and_wait();
+    }
+
+    RangeWorkers(const RangeWorkers&) = delete;
+    RangeWorkers& operator=(const RangeWorkers&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(workers_.size()) + 1; }
+
+    // 範囲 [0, count) をスレッド数で分けて、それぞれのスレッドで f(スレッド番号, begin, end) を呼ぶ。
+    // 呼んだスレッドが 0 番を受け持ち、全員が終わるまで待つ。
+    // 分け方は count とスレッド数だけで決まるので、同じ入力なら毎回同じ担当になる
+    template<typename F>
+    void run(std::size_t count, F&& f)
+    {
+        const unsigned threads = size();
+        if (threads == 1)
+        {
+            f(0u, std::size_t{ 0 }, count);
+            return;
+        }
+        job_ = [&f, count, threads](unsigned t) { f(t, count * t / threads, count * (t + 1) / threads); };
+        start_.arrive_and_wait();
+        job_(0);
+        done_.arrive_and_wait();
+    }
+
+private:
+    std::barrier<>                 start_;
+    std::barrier<>                 done_;
+    std::function<void(unsigned)>  job_;
+    bool                           stopping_ = false;
+    std::vector<std::jthread>      workers_; // 最後に宣言する（barrier より先に join される）
+};
+
+class CombatResolver
+{
+public:
+    // 攻撃の段階で各スレッドに渡す書き込み口
+    class Emitter
+    {
+    public:
+        explicit Emitter(std::vector<DamageEvent>& out) : out_(out) {}
+        void hit(std::uint32_t target, std::uint32_t source, std::int32_t amount)
+        {
+            out_.push_back({ target, source, amount });
+        }
+
+    private:
+        std::vector<DamageEvent>& out_;
+    };
+
+    explicit CombatResolver(unsigned threads)
+        : threads_(std::max(1u, threads))
+        , workers_(static_cast<unsigned>(threads_))
+        , buffers_(threads_)
+    {
+    }
+
+    // 段階1：attack(攻撃者の番号, Emitter&) を全攻撃者について並列に呼ぶ
+    template<typename F>
+    void attack_phase(std::size_t attackers, F&& attack)
+    {
+        workers_.run(attackers, [&](unsigned t, std::size_t begin, std::size_t end)
+        {
+            buffers_[t].clear();
+            Emitter emitter(buffers_[t]);
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                attack(i, emitter);
+            }
+        });
+    }
+
+    // 段階2と3：イベントを仕分けて、相手ごとに1回だけダメージを与える。倒れた相手を番号順に返す
+    std::vector<Death> resolve(std::span<IDamageable* const> targets)
+    {
+        const std::size_t n = targets.size();
+        const std::size_t shards = std::min<std::size_t>(std::max<std::size_t>(n, 1), threads_ * 8);
+        const std::size_t shard_size = (n + shards - 1) / shards;
+        total_.assign(n, 0);
+        top_.assign(n, 0);
+        killer_.assign(n, 0);
+
+        // 段階2a：バッファごと・シャードごとのイベント数を数える
+        counts_.assign(threads_ * shards, 0);
+        workers_.run(threads_, [&](unsigned, std::size_t begin, std::size_t end)
+        {
+            for (std::size_t b = begin; b < end; ++b)
+            {
+                for (const DamageEvent& e : buffers_[b])
+                {
+                    ++counts_[b * shards + e.target / shard_size];
+                }
+            }
+        });
+
+        // 段階2b：書き込み位置を決める。並びは「シャード → バッファ → バッファ内の順」
+        offsets_.resize(threads_ * shards);
+        shard_begin_.resize(shards + 1);
+        std::size_t pos = 0;
+        for (std::size_t k = 0; k < shards; ++k)
+        {
+            shard_begin_[k] = pos;
+            for (std::size_t b = 0; b < threads_; ++b)
+            {
+                offsets_[b * shards + k] = pos;
+                pos += counts_[b * shards + k];
+            }
+        }
+        shard_begin_[shards] = pos;
+
+        // 段階2c：各バッファが自分の担当位置へ書き写す（書き込み先が重ならないので並列にできる）
+        sorted_.resize(pos);
+        workers_.run(threads_, [&](unsigned, std::size_t begin, std::size_t end)
+        {
+            for (std::size_t b = begin; b < end; ++b)
+            {
+                std::size_t* next = offsets_.data() + b * shards;
+                for (const DamageEvent& e : buffers_[b])
+                {
+                    sorted_[next[e.target / shard_size]++] = e;
+                }
+            }
+        });
+
+        // 段階3：シャードごとに合計して適用する
+        std::vector<std::vector<Death>> shard_deaths(shards);
+        workers_.run(shards, [&](unsigned, std::size_t begin, std::size_t end)
+        {
+            for (std::size_t k = begin; k < end; ++k)
+            {
+                for (std::size_t i = shard_begin_[k]; i < shard_begin_[k + 1]; ++i)
+                {
+                    const DamageEvent& e = sorted_[i];
+                    total_[e.target] += e.amount;
+                    if (e.amount > top_[e.target] || (e.amount == top_[e.target] && e.source < killer_[e.target]))
+                    {
+                        top_[e.target] = e.amount;
+                        killer_[e.target] = e.source;
+                    }
+                }
+                const std::size_t first = k * shard_size;
+                const std::size_t last = std::min(n, first + shard_size);
+                for (std::size_t t = first; t < last; ++t)
+                {
+                    if (total_[t] <= 0 || targets[t]->isDead())
+                    {
+                        continue;
+                    }
+                    targets[t]->takeDamage(static_cast<int>(std::min<std::int64_t>(total_[t], INT32_MAX)));
+                    if (targets[t]->isDead())
+                    {
+                        shard_deaths[k].push_back({ static_cast<std::uint32_t>(t), killer_[t] });
+                    }
+                }
+            }
+        });
+
+        // シャードは番号の範囲順なので、つなげるだけで番号順になる
+        std::vector<Death> deaths;
+        for (auto& d : shard_deaths)
+        {
+            deaths.insert(deaths.end(), d.begin(), d.end());
+        }
+        return deaths;
+    }
+
+    std::size_t event_count() const { return sorted_.size(); }
+
+private:
+    std::size_t                           threads_;
+    RangeWorkers                          workers_;
+    std::vector<std::vector<DamageEvent>> buffers_;     // スレッドごとのイベント
+    std::vector<DamageEvent>              sorted_;      // シャード順に並べ直したイベント
+    std::vector<std::size_t>              counts_;      // [バッファ][シャード] のイベント数
+    std::vector<std::size_t>              offsets_;     // [バッファ][シャード] の書き込み位置
+    std::vector<std::size_t>              shard_begin_; // シャード k のイベントは [shard_begin_[k], shard_begin_[k+1])
+    std::vector<std::int64_t>             total_;       // 相手ごとの合計ダメージ
+    std::vector<std::int32_t>             top_;         // 相手ごとの1回の最大ダメージ
+    std::vector<std::uint32_t>            killer_;
+};
+
+// --- 戦うユニット ---
+class Unit : public IDamageable
+{
+private:
+    std::string name;
+    int hp;
+    int attack;
+    int lastDamage = 0; // 直前の takeDamage で受けたダメージ
+    bool verbose;
+
+public:
+    Unit(std::string n, int h, int a, bool v = false) : name(std::move(n)), hp(h), attack(a), verbose(v) {}
+
+    // resolve の並列の段階から呼ばれるので、ここでは表示しない（表示は集計が終わってから）
+    void takeDamage(int damage) override
+    {
+        hp -= damage;
+        lastDamage = damage;
+    }
+
+    bool isDead() const override { return hp <= 0; }
+
+    void onDeath(std::uint32_t killer) override
+    {
+        if (verbose)
+        {
+            std::cout << "  " << name << "は倒れた（とどめ: " << killer << "番）\n";
+        }
+    }
+
+    int getHp() const { return hp; }
+    int getLastDamage() const { return lastDamage; }
+    int getAttack() const { return attack; }
+    const std::string& getName() const { return name; }
+};
+
+// 攻撃者と tick から決まる疑似乱数（どのスレッドで計算しても同じ値になる）
+std::uint64_t mix(std::uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+struct BattleResult
+{
+    std::vector<int>   hp;
+    std::vector<Death> deaths;
+    long long          attack_us = 0;
+    long long          resolve_us = 0;
+};
+
+BattleResult run_battle(unsigned threads, std::size_t unit_count, int ticks)
+{
+    using Clock = std::chrono::steady_clock;
+    std::vector<Unit> units;
+    units.reserve(unit_count);
+    for (std::size_t i = 0; i < unit_count; ++i)
+    {
+        units.emplace_back("unit" + std::to_string(i), 200 + static_cast<int>(mix(i) % 300), 5 + static_cast<int>(mix(i + unit_count) % 20));
+    }
+    std::vector<IDamageable*> targets;
+    for (Unit& u : units)
+    {
+        targets.push_back(&u);
+    }
+
+    CombatResolver resolver(threads);
+    BattleResult result;
+    for (int tick = 0; tick < ticks; ++tick)
+    {
+        auto start = Clock::now();
+        resolver.attack_phase(units.size(), [&](std::size_t i, CombatResolver::Emitter& out)
+        {
+            if (units[i].isDead())
+            {
+                return;
+            }
+            // 3回攻撃する。相手が倒れていれば空振り（この段階では hp を読むだけ）
+            for (std::uint64_t k = 0; k < 3; ++k)
+            {
+                const auto target = static_cast<std::uint32_t>(mix((static_cast<std::uint64_t>(tick) << 40) ^ (i << 2) ^ k) % units.size());
+                if (target != i && !units[target].isDead())
+                {
+                    out.hit(target, static_cast<std::uint32_t>(i), units[i].getAttack());
+                }
+            }
+        });
+        auto mid = Clock::now();
+        const std::vector<Death> deaths = resolver.resolve(targets);
+        for (const Death& d : deaths)
+        {
+            targets[d.target]->onDeath(d.killer);
+        }
+        result.attack_us += std::chrono::duration_cast<std::chrono::microseconds>(mid - start).count();
+        result.resolve_us += std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - mid).count();
+        result.deaths.insert(result.deaths.end(), deaths.begin(), deaths.end());
+    }
+    for (const Unit& u : units)
+    {
+        result.hp.push_back(u.getHp());
+    }
+    return result;
+}
+
+int main()
+{
+    // --- 小さな例：同じ相手への攻撃は合計されて1回で入る ---
+    std::cout << "=== 1ティックの戦闘 ===\n";
+    std::vector<Unit> party;
+    party.emplace_back("勇者", 100, 30, true);
+    party.emplace_back("スライム", 50, 10, true);
+    party.emplace_back("ゴブリン", 80, 15, true);
+    std::vector<IDamageable*> targets = { &party[0], &party[1], &party[2] };
+
+    CombatResolver resolver(2);
+    resolver.attack_phase(party.size(), [&](std::size_t i, CombatResolver::Emitter& out)
+    {
+        if (i == 0)
+        {
+            out.hit(1, 0, party[0].getAttack()); // 勇者 → スライム
+        }
+        else
+        {
+            out.hit(0, static_cast<std::uint32_t>(i), party[i].getAttack()); // 敵 → 勇者
+            out.hit(1, static_cast<std::uint32_t>(i), 25);                   // 味方への誤爆
+        }
+    });
+    const std::vector<Death> deaths = resolver.resolve(targets);
+    // 並列の段階が終わってから、番号順に表示する
+    for (const Unit& u : party)
+    {
+        if (u.getLastDamage() > 0)
+        {
+            std::cout << "  " << u.getName() << "は" << u.getLastDamage() << "ダメージ! HP:" << u.getHp() << "\n";
+        }
+    }
+    for (const Death& d : deaths)
+    {
+        targets[d.target]->onDeath(d.killer);
+    }
+
+    // --- 大きな例：スレッド数を変えても結果が同じか ---
+    constexpr std::size_t UNITS = 200'000;
+    constexpr int TICKS = 20;
+    const unsigned hw = std::max(2u, std::thread::hardware_concurrency());
+    std::cout << "\n=== " << UNITS << "体 x " << TICKS << "ティック ===\n";
+
+    const BattleResult one = run_battle(1, UNITS, TICKS);
+    const BattleResult many = run_battle(hw, UNITS, TICKS);
+    std::cout << "1スレッド:  攻撃 " << one.attack_us / 1000 << "ms / 集計と適用 " << one.resolve_us / 1000 << "ms\n";
+    std::cout << hw << "スレッド: 攻撃 " << many.attack_us / 1000 << "ms / 集計と適用 " << many.resolve_us / 1000 << "ms\n";
+
+    const bool same_hp = one.hp == many.hp;
+    const bool same_deaths = std::equal(one.deaths.begin(), one.deaths.end(), many.deaths.begin(), many.deaths.end(),
+        [](const Death& a, const Death& b) { return a.target == b.target && a.killer == b.killer; });
+    std::cout << "倒れた数: " << one.deaths.size() << "\n";
+    std::cout << "HP: " << (same_hp ? "一致" : "不一致!") << " / 倒れた順ととどめ: " << (same_deaths ? "一致" : "不一致!") << "\n";
+    return same_hp && same_deaths ? 0 : 1;
+}
@@ -0,0 +1,614 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+// --- アーキタイプ方式のエンティティ・コンポーネント・システム（ECS） ---
+// lesson20_3 では「動けるもの」を IMovable の実装として表し、
+// データ（hp や x, y）と処理（move や takeDamage）を1つのオブジェクトにまとめていた。
+// 数万体を毎フレーム動かすと、オブジェクトごとに別の場所のメモリを読み、仮想関数を1回ずつ呼ぶことになる。
+//
+// ECS では役割を3つに分ける。
+//   エンティティ   … ただの番号（Entity）
+//   コンポーネント … データだけの構造体（Position, Velocity, Health …）
+//   システム       … 「このコンポーネントを全部持つもの」をまとめて処理する関数
+// 「IMovable を実装している」は「Velocity を持っている」になる。
+//
+// 同じ組み合わせのコンポーネントを持つエンティティは同じ「アーキタイプ」に入り、
+// 16KB のチャンクの中に、コンポーネントごとの列（Position の配列、Velocity の配列 …）として並ぶ。
+// query<Position, Velocity>() は条件に合うアーキタイプの一覧を覚えておき、
+// システムはそのチャンクを先頭から順になめるだけになる。
+//
+// ⚠️ コンポーネントはトリビアルコピー可能な型に限る（アーキタイプ間の移動を memcpy で行うため）
+// ⚠️ each() の途中でエンティティを作ったり、コンポーネントを付け外ししたりしないこと
+
+struct Entity
+{
+    std::uint32_t index;
+    std::uint32_t generation; // 同じ番号が再利用されても、古い Entity とは区別できる
+
+    bool operator==(const Entity&) const = default;
+};
+
+using ComponentMask = std::uint64_t; // コンポーネントは64種類まで
+
+// 型ごとに 0, 1, 2 … と番号を振る
+inline std::uint32_t next_component_id()
+{
+    static std::uint32_t next = 0;
+    return next++;
+}
+
+template<typename T>
+std::uint32_t component_id()
+{
+    static_assert(std::is_trivially_copyable_v<T>, "コンポーネントはトリビアルコピー可能な型にする");
+    static const std::uint32_t id = next_component_id();
+    return id;
+}
+
+class World
+{
+    static constexpr std::size_t CHUNK_BYTES = 16 * 1024;
+    static constexpr std::size_t MAX_COMPONENTS = 64;
+
+    struct ComponentInfo
+    {
+        std::size_t size = 0;
+        std::size_t align = 0;
+    };
+
+    struct Chunk
+    {
+        alignas(64) std::byte data[CHUNK_BYTES];
+    };
+
+    struct Archetype
+    {
+        ComponentMask                                 mask = 0;
+        std::vector<std::uint32_t>                    types;          // 番号の小さい順
+        std::array<std::int8_t, MAX_COMPONENTS>       column{};       // 型の番号 → types の何番目か（ないなら -1）
+        std::vector<std::size_t>                      offsets;        // チャンク内の列の開始位置（types と同じ順）
+        std::vector<std::size_t>                      sizes;
+        std::size_t                                   capacity = 0;   // 1チャンクの行数
+        std::size_t                                   count = 0;      // 全チャンクの行数（最後のチャンク以外は満杯）
+        std::vector<std::unique_ptr<Chunk>>           chunks;
+        std::unordered_map<std::uint32_t, Archetype*> add_edge;       // コンポーネントを1つ足したときの行き先
+        std::unordered_map<std::uint32_t, Archetype*> remove_edge;
+
+        Entity* entities(Chunk& chunk) const { return reinterpret_cast<Entity*>(chunk.data); }
+        std::byte* at(std::size_t row, std::size_t col) const
+        {
+            return chunks[row / capacity]->data + offsets[col] + (row % capacity) * sizes[col];
+        }
+        Entity& entity_at(std::size_t row) const { return entities(*chunks[row / capacity])[row % capacity]; }
+    };
+
+    struct Record
+    {
+        Archetype*    archetype = nullptr;
+        std::size_t   row = 0;
+        std::uint32_t generation = 0;
+    };
+
+public:
+    // --- 条件に合うアーキタイプの一覧を覚えておく問い合わせ ---
+    template<typename... Ts>
+    class Query
+    {
+    public:
+        // 1体ずつ f(Position&, Velocity&, ...) を呼ぶ
+        template<typename F>
+        void each(F&& f)
+        {
+            each_chunk([&](std::size_t n, Ts*... columns)
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    f(columns[i]...);
+                }
+            });
+        }
+
+        // チャンクごとに f(行数, Position*, Velocity*, ...) を呼ぶ（列をそのままループできる）
+        template<typename F>
+        void each_chunk(F&& f)
+        {
+            refresh();
+            for (Archetype* a : matched_)
+            {
+                const std::array<std::int8_t, sizeof...(Ts)> cols{ a->column[component_id<Ts>()]... };
+                for (std::size_t c = 0; c < a->chunks.size(); ++c)
+                {
+                    const std::size_t n = std::min(a->capacity, a->count - c * a->capacity);
+                    call(f, n, *a, *a->chunks[c], cols, std::index_sequence_for<Ts...>{});
+                }
+            }
+        }
+
+        std::size_t count()
+        {
+            refresh();
+            std::size_t n = 0;
+            for (const Archetype* a : matched_)
+            {
+                n += a->count;
+            }
+            return n;
+        }
+
+    private:
+        friend class World;
+        explicit Query(World& world) : world_(world), mask_(((ComponentMask{ 1 } << component_id<Ts>()) | ...)) {}
+
+        // 前回から増えたアーキタイプだけを調べる
+        void refresh()
+        {
+            for (; seen_ < world_.archetypes_.size(); ++seen_)
+            {
+                Archetype* a = world_.archetypes_[seen_].get();
+                if ((a->mask & mask_) == mask_)
+                {
+                    matched_.push_back(a);
+                }
+            }
+        }
+
+        template<typename F, std::size_t... I>
+        static void call(F& f, std::size_t n, const Archetype& a, Chunk& chunk,
+                         const std::array<std::int8_t, sizeof...(Ts)>& cols, std::index_sequence<I...>)
+        {
+            f(n, reinterpret_cast<Ts*>(chunk.data + a.offsets[cols[I]])...);
+        }
+
+        World&                  world_;
+        ComponentMask           mask_;
+        std::vector<Archetype*> matched_;
+        std::size_t             seen_ = 0;
+    };
+
+    World()
+    {
+        Archetype& empty = *archetypes_.emplace_back(std::make_unique<Archetype>());
+        build_layout(empty);
+        by_mask_[0] = &empty;
+    }
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    // 同じコンポーネントを持つエンティティを n 体まとめて作る。行はチャンクの末尾に続けて書く
+    template<typename... Ts>
+    std::vector<Entity> create(std::size_t n, const Ts&... values)
+    {
+        Archetype& a = archetype_for((ComponentMask{ 0 } | ... | (ComponentMask{ 1 } << register_component<Ts>())));
+        std::vector<Entity> out;
+        out.reserve(n);
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            const Entity e = allocate_entity();
+            const std::size_t row = push_row(a, e);
+            (write_value(a, row, values), ...);
+            records_[e.index].archetype = &a;
+            records_[e.index].row = row;
+            out.push_back(e);
+        }
+        return out;
+    }
+
+    // まとめてコンポーネントを付ける。同じアーキタイプから来た行は、行き先の検索を1回で済ませる
+    template<typename T>
+    void add(std::span<const Entity> entities, const T& value)
+    {
+        const std::uint32_t id = register_component<T>();
+        Archetype* from = nullptr;
+        Archetype* to = nullptr;
+        for (const Entity e : entities)
+        {
+            Record& r = record(e);
+            if (r.archetype->mask & (ComponentMask{ 1 } << id))
+            {
+                write_value(*r.archetype, r.row, value); // すでに持っているなら上書き
+                continue;
+            }
+            if (r.archetype != from)
+            {
+                from = r.archetype;
+                to = edge(*from, id, true);
+            }
+            move_row(e, *to);
+            write_value(*to, r.row, value);
+        }
+    }
+
+    template<typename T>
+    void remove(std::span<const Entity> entities)
+    {
+        const std::uint32_t id = register_component<T>();
+        Archetype* from = nullptr;
+        Archetype* to = nullptr;
+        for (const Entity e : entities)
+        {
+            Record& r = record(e);
+            if (!(r.archetype->mask & (ComponentMask{ 1 } << id)))
+            {
+                continue;
+            }
+            if (r.archetype != from)
+            {
+                from = r.archetype;
+                to = edge(*from, id, false);
+            }
+            move_row(e, *to);
+        }
+    }
+
+    void destroy(std::span<const Entity> entities)
+    {
+        for (const Entity e : entities)
+        {
+            Record& r = record(e);
+            erase_row(*r.archetype, r.row);
+            r.archetype = nullptr;
+            ++r.generation;
+            free_.push_back(e.index);
+        }
+    }
+
+    bool alive(Entity e) const
+    {
+        return e.index < records_.size() && records_[e.index].generation == e.generation && records_[e.index].archetype;
+    }
+
+    // 持っていなければ nullptr
+    template<typename T>
+    T* get(Entity e)
+    {
+        const Record& r = record(e);
+        const std::int8_t col = component_id<T>() < MAX_COMPONENTS ? r.archetype->column[component_id<T>()] : -1;
+        return col < 0 ? nullptr : reinterpret_cast<T*>(r.archetype->at(r.row, col));
+    }
+
+    // 同じ型の並びなら、同じ Query を使い回す
+    // （<A, B> と <B, A> はマスクが同じでも列の並びが違う別の型なので、マスクではなく型で引く）
+    template<typename... Ts>
+    Query<Ts...>& query()
+    {
+        (register_component<Ts>(), ...);
+        std::unique_ptr<QueryBase>& slot = queries_[typeid(QueryHolder<Ts...>)];
+        if (!slot)
+        {
+            slot = std::make_unique<QueryHolder<Ts...>>(*this);
+        }
+        return static_cast<QueryHolder<Ts...>&>(*slot).query;
+    }
+
+    std::size_t archetype_count() const { return archetypes_.size(); }
+
+private:
+    struct QueryBase
+    {
+        virtual ~QueryBase() {}
+    };
+
+    template<typename... Ts>
+    struct QueryHolder : QueryBase
+    {
+        explicit QueryHolder(World& world) : query(world) {}
+        Query<Ts...> query;
+    };
+
+    template<typename T>
+    std::uint32_t register_component()
+    {
+        const std::uint32_t id = component_id<T>();
+        if (id >= MAX_COMPONENTS)
+        {
+            throw std::length_error("コンポーネントの種類が多すぎる");
+        }
+        if (infos_.size() <= id)
+        {
+            infos_.resize(id + 1);
+        }
+        infos_[id] = { sizeof(T), alignof(T) };
+        return id;
+    }
+
+    // チャンクの先頭に Entity の列、続けてコンポーネントの列を置く。
+    // 1行の合計バイト数から、1チャンクに入る行数を決める
+    void build_layout(Archetype& a)
+    {
+        a.column.fill(-1);
+        std::size_t row_bytes = sizeof(Entity);
+        for (std::uint32_t id = 0; id < MAX_COMPONENTS; ++id)
+        {
+            if (a.mask & (ComponentMask{ 1 } << id))
+            {
+                a.column[id] = static_cast<std::int8_t>(a.types.size());
+                a.types.push_back(id);
+                a.sizes.push_back(infos_[id].size);
+                row_bytes += infos_[id].size;
+            }
+        }
+        // 列ごとの端数合わせの分だけ余らせる
+        a.capacity = (CHUNK_BYTES - 64 * (a.types.size() + 1)) / row_bytes;
+        std::size_t offset = a.capacity * sizeof(Entity);
+        for (std::size_t c = 0; c < a.types.size(); ++c)
+        {
+            const std::size_t align = std::max<std::size_t>(infos_[a.types[c]].align, 16);
+            offset = (offset + align - 1) / align * align;
+            a.offsets.push_back(offset);
+            offset += a.capacity * a.sizes[c];
+        }
+    }
+
+    Archetype& archetype_for(ComponentMask mask)
+    {
+        Archetype*& slot = by_mask_[mask];
+        if (!slot)
+        {
+            Archetype& a = *archetypes_.emplace_back(std::make_unique<Archetype>());
+            a.mask = mask;
+            build_layout(a);
+            slot = &a;
+        }
+        return *slot;
+    }
+
+    Archetype* edge(Archetype& from, std::uint32_t id, bool add)
+    {
+        auto& edges = add ? from.add_edge : from.remove_edge;
+        Archetype*& to = edges[id];
+        if (!to)
+        {
+            const ComponentMask bit = ComponentMask{ 1 } << id;
+            to = &archetype_for(add ? from.mask | bit : from.mask & ~bit);
+        }
+        return to;
+    }
+
+    Entity allocate_entity()
+    {
+        if (!free_.empty())
+        {
+            const std::uint32_t index = free_.back();
+            free_.pop_back();
+            return { index, records_[index].generation };
+        }
+        records_.emplace_back();
+        return { static_cast<std::uint32_t>(records_.size() - 1), 0 };
+    }
+
+    Record& record(Entity e)
+    {
+        if (!alive(e))
+        {
+            throw std::invalid_argument("すでに消えたエンティティ");
+        }
+        return records_[e.index];
+    }
+
+    std::size_t push_row(Archetype& a, Entity e)
+    {
+        if (a.count == a.chunks.size() * a.capacity)
+        {
+            a.chunks.push_back(std::make_unique_for_overwrite<Chunk>());
+        }
+        const std::size_t row = a.count++;
+        a.entity_at(row) = e;
+        return row;
+    }
+
+    template<typename T>
+    void write_value(Archetype& a, std::size_t row, const T& value)
+    {
+        std::memcpy(a.at(row, a.column[component_id<T>()]), &value, sizeof(T));
+    }
+
+    // 末尾の行を row に移して詰める。空になったチャンクは手放す
+    void erase_row(Archetype& a, std::size_t row)
+    {
+        const std::size_t last = a.count - 1;
+        if (row != last)
+        {
+            for (std::size_t c = 0; c < a.types.size(); ++c)
+            {
+                std::memcpy(a.at(row, c), a.at(last, c), a.sizes[c]);
+            }
+            const Entity moved = a.entity_at(last);
+            a.entity_at(row) = moved;
+            records_[moved.index].row = row;
+        }
+        --a.count;
+        if (a.count == (a.chunks.size() - 1) * a.capacity)
+        {
+            a.chunks.pop_back();
+        }
+    }
+
+    // 共通するコンポーネントだけ写して、別のアーキタイプへ引っ越す
+    void move_row(Entity e, Archetype& to)
+    {
+        Record& r = records_[e.index];
+        Archetype& from = *r.archetype;
+        const std::size_t row = push_row(to, e);
+        for (std::size_t c = 0; c < to.types.size(); ++c)
+        {
+            const std::int8_t src = from.column[to.types[c]];
+            if (src >= 0)
+            {
+                std::memcpy(to.at(row, c), from.at(r.row, src), to.sizes[c]);
+            }
+        }
+        erase_row(from, r.row);
+        r.archetype = &to;
+        r.row = row;
+    }
+
+    std::vector<ComponentInfo>                                   infos_;
+    std::vector<std::unique_ptr<Archetype>>                      archetypes_; // 消さないので Archetype* は使い続けられる
+    std::unordered_map<ComponentMask, Archetype*>                by_mask_;
+    std::unordered_map<std::type_index, std::unique_ptr<QueryBase>> queries_;
+    std::vector<Record>                                          records_;
+    std::vector<std::uint32_t>                                   free_;
+};
+
+// --- コンポーネント ---
+struct Position
+{
+    float x, y;
+};
+
+struct Velocity // 「IMovable を実装している」の代わり
+{
+    float x, y;
+};
+
+struct Health // 「IDamageable を実装している」の代わり
+{
+    std::int32_t hp;
+};
+
+struct Attack
+{
+    std::int32_t power;
+};
+
+// --- システム ---
+void movement_system(World& world, float dt)
+{
+    world.query<Position, Velocity>().each_chunk([dt](std::size_t n, Position* p, Velocity* v)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            p[i].x += v[i].x * dt;
+            p[i].y += v[i].y * dt;
+        }
+    });
+}
+
+void damage_system(World& world, std::int32_t damage)
+{
+    world.query<Health>().each([damage](Health& h) { h.hp -= damage; });
+}
+
+// --- 比較用：lesson20_3 と同じ、インターフェースを実装したオブジェクト ---
+class IMovable
+{
+public:
+    virtual void move(float x, float y) = 0;
+    virtual ~IMovable() {}
+};
+
+class Enemy : public IMovable
+{
+public:
+    Enemy(std::string n, float vx, float vy) : name(std::move(n)), x(0), y(0), vx(vx), vy(vy) {}
+    void move(float dx, float dy) override
+    {
+        x += dx;
+        y += dy;
+    }
+
+    std::string name;
+    float x, y, vx, vy;
+    int hp = 100;
+};
+
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+    World world;
+
+    // lesson20_3 の Player / Enemy / Building を、持っているコンポーネントの違いで表す
+    const auto players = world.create(1, Position{ 0, 0 }, Velocity{ 1, 0 }, Health{ 100 });
+    const auto enemies = world.create(3, Position{ 10, 0 }, Velocity{ -1, 0 }, Health{ 50 }, Attack{ 15 });
+    const auto buildings = world.create(2, Position{ 5, 5 }, Health{ 500 });
+
+    movement_system(world, 1.0f);
+    damage_system(world, 10);
+    std::cout << "動けるもの: " << world.query<Position, Velocity>().count()
+              << " / ダメージを受けるもの: " << world.query<Health>().count() << "\n";
+    // 型の並びを逆にしたクエリは別物として作られ、引数もその並びで渡される
+    float speed_sum = 0;
+    world.query<Velocity, Position>().each([&](const Velocity& v, const Position&) { speed_sum += v.x; });
+    std::cout << "query<Velocity, Position>: " << world.query<Velocity, Position>().count() << "件, 速度 x の合計 " << speed_sum << "\n";
+    std::cout << "プレイヤー: (" << world.get<Position>(players[0])->x << ", " << world.get<Position>(players[0])->y
+              << ") HP:" << world.get<Health>(players[0])->hp << "\n";
+    std::cout << "建物 HP:" << world.get<Health>(buildings[0])->hp << "\n";
+
+    // 敵を凍らせる：Velocity を外すだけで、動くもののクエリから外れる
+    world.remove<Velocity>(enemies);
+    movement_system(world, 1.0f);
+    std::cout << "凍った敵: (" << world.get<Position>(enemies[0])->x << ", " << world.get<Position>(enemies[0])->y
+              << ") / Velocity " << (world.get<Velocity>(enemies[0]) ? "あり" : "なし")
+              << " / 動けるもの: " << world.query<Position, Velocity>().count() << "\n";
+    world.add(enemies, Velocity{ 0, 2 });
+    movement_system(world, 1.0f);
+    std::cout << "溶けた敵: (" << world.get<Position>(enemies[0])->x << ", " << world.get<Position>(enemies[0])->y
+              << ") / アーキタイプ " << world.archetype_count() << "個\n\n";
+
+    // --- 速さ：仮想関数の move と、チャンクをなめるシステム ---
+    constexpr std::size_t COUNT = 1'000'000;
+    constexpr int FRAMES = 100;
+
+    std::vector<std::unique_ptr<Enemy>> objects;
+    objects.reserve(COUNT);
+    for (std::size_t i = 0; i < COUNT; ++i)
+    {
+        objects.push_back(std::make_unique<Enemy>("スライム", 1.0f, static_cast<float>(i % 3)));
+    }
+    std::vector<IMovable*> movables(objects.size());
+    std::transform(objects.begin(), objects.end(), movables.begin(), [](const auto& p) { return p.get(); });
+    auto start = Clock::now();
+    for (int f = 0; f < FRAMES; ++f)
+    {
+        for (IMovable* m : movables)
+        {
+            const Enemy& e = static_cast<const Enemy&>(*m); // 速度も同じオブジェクトから読む
+            m->move(e.vx * 0.016f, e.vy * 0.016f);
+        }
+    }
+    const auto virtual_ms = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+
+    World big;
+    start = Clock::now();
+    const auto slimes = big.create(COUNT, Position{ 0, 0 }, Velocity{ 1, 1 }, Health{ 100 });
+    const auto create_ms = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+
+    start = Clock::now();
+    for (int f = 0; f < FRAMES; ++f)
+    {
+        movement_system(big, 0.016f);
+    }
+    const auto ecs_ms = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+
+    // 半分に Attack を付けて、また外す（アーキタイプ間の引っ越し）
+    const std::span<const Entity> half(slimes.data(), COUNT / 2);
+    start = Clock::now();
+    big.add(half, Attack{ 20 });
+    big.remove<Attack>(half);
+    const auto migrate_ms = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+
+    float checksum = objects[COUNT - 1]->x;
+    big.query<Position>().each([&](const Position& p) { checksum += p.x * 1e-9f; });
+
+    std::cout << COUNT << "体 x " << FRAMES << "フレームの移動\n";
+    std::cout << "  IMovable::move（仮想関数）: " << virtual_ms << "ms\n";
+    std::cout << "  query<Position, Velocity>:  " << ecs_ms << "ms\n";
+    std::cout << "  " << COUNT << "体をまとめて作成: " << create_ms << "ms\n";
+    std::cout << "  " << COUNT / 2 << "体に Attack を付けて外す: " << migrate_ms << "ms\n";
+    std::cout << "  (checksum " << checksum << ")\n";
+    return 0;
+}
@@ -0,0 +1,209 @@
+#include <barrier>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lesson21_5.hpp"
+
+// --- 1フレームの時間がどこで使われたかを区間トレースで調べる ---
+// lesson21_3 の renderSystem / physicsSystem に、AI と戦闘を足したゲームループ。
+// AI は3つのワーカースレッドで並列に動かす。各処理の先頭に TRACE_SCOPE を置くだけで、
+// スレッドごとの区間が記録され、Chrome / Perfetto のフレームグラフで見られる。
+//   trace.json … chrome://tracing か https://ui.perfetto.dev に読み込む
+//   trace.bin  … 同じ内容の小さなバイナリ（read_binary で読み戻せる）
+// 時々だけ遅くなるフレーム（ヒッチ）を作っておき、記録から見つけ出す
+
+class Enemy
+{
+public:
+    std::string name;
+    int hp;
+    float x = 0, y = 0;
+
+    Enemy(std::string n, int h) : name(n), hp(h) {}
+};
+
+// 重さを変えられる計算（最適化で消えないように結果を返す）
+float busy_work(int n)
+{
+    float acc = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        acc += std::sqrt(static_cast<float>(i));
+    }
+    return acc;
+}
+
+void renderSystem(const std::vector<std::shared_ptr<Enemy>>& enemies)
+{
+    TRACE_SCOPE("renderSystem");
+    float sink = 0;
+    for (const auto& enemy : enemies)
+    {
+        sink += enemy->x + enemy->y;
+    }
+    sink += busy_work(20'000);
+    static_cast<void>(sink);
+}
+
+void physicsSystem(const std::vector<std::shared_ptr<Enemy>>& enemies, int frame)
+{
+    TRACE_SCOPE("physicsSystem");
+    {
+        TRACE_SCOPE("integrate");
+        for (const auto& enemy : enemies)
+        {
+            enemy->x += 0.1f;
+        }
+    }
+    {
+        TRACE_SCOPE("collision");
+        // 37 フレーム目だけ、当たり判定が急に重くなる
+        const float r = busy_work(frame == 37 ? 3'000'000 : 30'000);
+        enemies[0]->y += r * 1e-12f;
+    }
+}
+
+void aiSystem(const std::vector<std::shared_ptr<Enemy>>& enemies, std::size_t begin, std::size_t end)
+{
+    TRACE_SCOPE("ai");
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        enemies[i]->y += 0.01f;
+    }
+    busy_work(15'000);
+}
+
+void combatSystem(const std::vector<std::shared_ptr<Enemy>>& enemies)
+{
+    TRACE_SCOPE("combat");
+    for (const auto& enemy : enemies)
+    {
+        enemy->hp -= 1;
+    }
+}
+
+int main()
+{
+    trace::set_thread_name("main");
+    std::vector<std::shared_ptr<Enemy>> enemies;
+    for (int i = 0; i < 1000; ++i)
+    {
+        enemies.push_back(std::make_shared<Enemy>("スライム" + std::to_string(i), 1000));
+    }
+
+    // --- ゲームループ ---
+    // AI のワーカーは最初に作って使い回す（スレッドごとのバッファは一度作ったら残り続けるため）
+    constexpr int FRAMES = 60;
+    constexpr unsigned AI_THREADS = 3;
+    std::barrier frame_start(AI_THREADS + 1);
+    std::barrier frame_done(AI_THREADS + 1);
+    bool quit = false;
+    std::vector<std::jthread> workers;
+    for (unsigned t = 0; t < AI_THREADS; ++t)
+    {
+        workers.emplace_back([&, t]
+        {
+            trace::set_thread_name("ai worker " + std::to_string(t));
+            for (;;)
+            {
+                frame_start.arrive_and_wait();
+                if (quit)
+                {
+                    return;
+                }
+                aiSystem(enemies, enemies.size() * t / AI_THREADS, enemies.size() * (t + 1) / AI_THREADS);
+                frame_done.arrive_and_wait();
+            }
+        });
+    }
+    for (int frame = 0; frame < FRAMES; ++frame)
+    {
+        TRACE_SCOPE("frame");
+        {
+            TRACE_SCOPE("ai (fork/join)");
+            frame_start.arrive_and_wait();
+            frame_done.arrive_and_wait();
+        }
+        physicsSystem(enemies, frame);
+        combatSystem(enemies);
+        renderSystem(enemies);
+    }
+    quit = true;
+    frame_start.arrive_and_wait();
+    workers.clear();
+
+    // --- 記録から、いちばん遅かったフレームとその内訳を探す ---
+    const std::vector<trace::Span> spans = trace::Tracer::instance().collect();
+    const trace::Span* worst = nullptr;
+    for (const trace::Span& s : spans)
+    {
+        if (std::string(s.site->name) == "frame" && (worst == nullptr || s.dur_ns > worst->dur_ns))
+        {
+            worst = &s;
+        }
+    }
+    if (worst != nullptr)
+    {
+        std::cout << "いちばん遅いフレーム: " << worst->dur_ns / 1000 << "us\n";
+        for (const trace::Span& s : spans)
+        {
+            if (s.tid == worst->tid && s.site != worst->site && s.begin_ns >= worst->begin_ns
+                && s.begin_ns + s.dur_ns <= worst->begin_ns + worst->dur_ns)
+            {
+                std::cout << "  " << s.site->name << ": " << s.dur_ns / 1000 << "us\n";
+            }
+        }
+    }
+
+    // --- 書き出しと読み戻し ---
+    if (trace::write_chrome_json("trace.json") && trace::write_binary("trace.bin", spans))
+    {
+        // 書いた spans と、名前・スレッド・開始・長さを1件ずつ比べる
+        trace::LoadedTrace loaded;
+        bool ok = trace::read_binary("trace.bin", loaded) && loaded.spans.size() == spans.size();
+        for (std::size_t i = 0; ok && i < spans.size(); ++i)
+        {
+            const trace::LoadedSpan& l = loaded.spans[i];
+            ok = l.name < loaded.names.size() && loaded.names[l.name] == spans[i].site->name && l.tid == spans[i].tid
+                 && l.begin_ns == spans[i].begin_ns && l.dur_ns == spans[i].dur_ns;
+        }
+        auto file_size = [](const char* path)
+        {
+            std::FILE* f = std::fopen(path, "rb");
+            std::fseek(f, 0, SEEK_END);
+            const long n = std::ftell(f);
+            std::fclose(f);
+            return n;
+        };
+        std::cout << "\n" << spans.size() << "区間（" << trace::Tracer::instance().thread_count() << "スレッド）を書き出し\n";
+        std::cout << "  trace.json: " << file_size("trace.json") << "バイト\n";
+        std::cout << "  trace.bin:  " << file_size("trace.bin") << "バイト（読み戻し: " << (ok ? "一致" : "不一致!") << "）\n";
+    }
+
+    // --- 1区間あたりのコスト ---
+    using Clock = std::chrono::steady_clock;
+    constexpr int SCOPES = 10'000'000;
+    auto measure = [&]
+    {
+        const auto start = Clock::now();
+        for (int i = 0; i < SCOPES; ++i)
+        {
+            TRACE_SCOPE("empty");
+        }
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / SCOPES;
+    };
+    const double on_ns = measure();
+    trace::set_enabled(false);
+    const double off_ns = measure();
+    std::cout << "\n空のスコープ x" << SCOPES << "\n";
+    std::cout << "  記録あり:            " << on_ns << "ns/区間\n";
+    std::cout << "  set_enabled(false):  " << off_ns << "ns/区間\n";
+    std::cout << "  （-DTRACE_ENABLED=0 ならコードごと消える）\n";
+    return 0;
+}
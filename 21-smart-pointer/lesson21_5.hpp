@@ -0,0 +1,555 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <x86intrin.h>
+#define TRACE_HAS_TSC 1
+#else
+#define TRACE_HAS_TSC 0
+#endif
+
+// --- 処理時間の区間トレース（Chrome / Perfetto で見られる JSON と、小さなバイナリに書き出す） ---
+// 1フレームの時間が renderSystem / physicsSystem / AI / 戦闘のどこで使われたかを見るためのもの。
+//
+//   void physicsSystem(...)
+//   {
+//       TRACE_SCOPE("physics");
+//       ...
+//   }
+//
+// TRACE_SCOPE はスコープに入ったときと出たときの時刻を取り、出たときに
+// 「区間の名前（呼び出し箇所ごとの静的なデータのアドレス）, 開始, 終了」の3つを
+// スレッドごとのリングバッファに1回書くだけ。ロックもメモリ確保もしない。
+// リングは古いものから上書きするので、直近の数秒ぶんがいつも残る（止まったフレームを後から調べられる）。
+//
+//   -DTRACE_ENABLED=0 … TRACE_SCOPE が空になり、コストはなくなる
+//   trace::set_enabled(false) … 実行中に止める（1回の読み込みと分岐だけが残る）
+//
+// 時刻は x86-64 では rdtsc のカウンタをそのまま記録し、書き出すときにナノ秒へ直す
+
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 1
+#endif
+
+namespace trace
+{
+    // 呼び出し箇所ごとに1つだけ静的に作られる情報。そのアドレスが区間の ID になる
+    struct Site
+    {
+        const char* name;
+        const char* file;
+        int         line;
+    };
+
+    struct Event
+    {
+        const Site*   site;
+        std::uint64_t begin; // カウンタの値（ticks）
+        std::uint64_t end;
+    };
+
+    inline std::uint64_t ticks()
+    {
+#if TRACE_HAS_TSC
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    // --- スレッドごとのリングバッファ（書くのは持ち主のスレッドだけ） ---
+    class ThreadBuffer
+    {
+    public:
+        static constexpr std::size_t CAPACITY = 1 << 16; // 6万5千区間（2 のべき乗）
+
+        ThreadBuffer(std::uint32_t tid, std::string name) : tid_(tid), name_(std::move(name)) {}
+
+        void push(const Site* site, std::uint64_t begin, std::uint64_t end)
+        {
+            const std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+            // この書き込みを読んだ snapshot が、読み直した tail で tail 以上を見るようにする
+            std::atomic_thread_fence(std::memory_order_release);
+            Slot& slot = slots_[tail & (CAPACITY - 1)];
+            slot.site.store(site, std::memory_order_relaxed);
+            slot.begin.store(begin, std::memory_order_relaxed);
+            slot.end.store(end, std::memory_order_relaxed);
+            tail_.store(tail + 1, std::memory_order_release);
+        }
+
+        // 残っている区間を out に足す。
+        // 書き出し中に持ち主が上書きしたかもしれない分は、写した後に tail を読み直して捨てる
+        void snapshot(std::vector<Event>& out) const
+        {
+            const std::uint64_t tail = tail_.load(std::memory_order_acquire);
+            const std::uint64_t first = tail > CAPACITY ? tail - CAPACITY : 0;
+            const std::size_t start = out.size();
+            for (std::uint64_t i = first; i < tail; ++i)
+            {
+                const Slot& slot = slots_[i & (CAPACITY - 1)];
+                out.push_back({ slot.site.load(std::memory_order_relaxed), slot.begin.load(std::memory_order_relaxed),
+                                slot.end.load(std::memory_order_relaxed) });
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            // tail が after なら、持ち主は after 番を書いている途中かもしれない。
+            // その書き込みは after - CAPACITY 番を上書きするので、そこまで捨てる
+            const std::uint64_t after = tail_.load(std::memory_order_relaxed);
+            const std::uint64_t overwritten = after + 1 > CAPACITY ? after + 1 - CAPACITY : 0;
+            if (overwritten > first)
+            {
+                const std::size_t n = static_cast<std::size_t>(std::min(overwritten, tail) - first);
+                out.erase(out.begin() + static_cast<std::ptrdiff_t>(start),
+                          out.begin() + static_cast<std::ptrdiff_t>(start + n));
+            }
+        }
+
+        std::uint32_t tid() const { return tid_; }
+
+    private:
+        // 名前は書き出し中にも読まれるので、Tracer が mutex_ を持って読み書きする
+        friend class Tracer;
+        const std::string& name() const { return name_; }
+        void               set_name(std::string name) { name_ = std::move(name); }
+
+        // 書き出し中に持ち主が書き込むこともあるので、各欄を relaxed のアトミックにする
+        struct Slot
+        {
+            std::atomic<const Site*>   site{ nullptr };
+            std::atomic<std::uint64_t> begin{ 0 };
+            std::atomic<std::uint64_t> end{ 0 };
+        };
+
+        std::unique_ptr<Slot[]>    slots_{ new Slot[CAPACITY] };
+        std::uint32_t              tid_;
+        std::string                name_;
+        alignas(64) std::atomic<std::uint64_t> tail_{ 0 };
+    };
+
+    // 書き出し用に、開始順に並べてナノ秒に直した区間
+    struct Span
+    {
+        const Site*   site;
+        std::uint32_t tid;
+        std::uint64_t begin_ns; // トレーサーを作ったときからの時間
+        std::uint64_t dur_ns;
+    };
+
+    class Tracer
+    {
+    public:
+        static Tracer& instance()
+        {
+            static Tracer tracer;
+            return tracer;
+        }
+
+        ThreadBuffer& local_buffer()
+        {
+            // constinit なので、2回目以降はガード変数を見ずにポインタを読むだけ
+            static constinit thread_local ThreadBuffer* buffer = nullptr;
+            if (buffer == nullptr)
+            {
+                buffer = register_thread();
+            }
+            return *buffer;
+        }
+
+        bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+        void set_enabled(bool on) { enabled_.store(on, std::memory_order_relaxed); }
+
+        // 全スレッドの区間を集める。スレッドが終わった後でもバッファは残っているので読める
+        std::vector<Span> collect() const
+        {
+            std::vector<Event> events;
+            std::vector<std::pair<std::size_t, std::uint32_t>> ranges; // (終わりの位置, tid)
+            {
+                std::lock_guard lock(mutex_);
+                for (const auto& b : buffers_)
+                {
+                    b->snapshot(events);
+                    ranges.emplace_back(events.size(), b->tid());
+                }
+            }
+            const double ns_per_tick = calibrate();
+            std::vector<Span> spans;
+            spans.reserve(events.size());
+            std::size_t i = 0;
+            for (const auto& [end, tid] : ranges)
+            {
+                for (; i < end; ++i)
+                {
+                    const Event& e = events[i];
+                    const std::uint64_t begin = e.begin > start_ticks_ ? e.begin - start_ticks_ : 0;
+                    spans.push_back({ e.site, tid, static_cast<std::uint64_t>(static_cast<double>(begin) * ns_per_tick),
+                                      static_cast<std::uint64_t>(static_cast<double>(e.end - e.begin) * ns_per_tick) });
+                }
+            }
+            std::sort(spans.begin(), spans.end(), [](const Span& a, const Span& b)
+            {
+                return a.tid != b.tid ? a.tid < b.tid : a.begin_ns < b.begin_ns;
+            });
+            return spans;
+        }
+
+        // このスレッドの名前を変える（書き出しと同時に呼ばれても壊れないよう、mutex_ を持って書く）
+        void set_thread_name(std::string name)
+        {
+            ThreadBuffer& buffer = local_buffer();
+            std::lock_guard lock(mutex_);
+            buffer.set_name(std::move(name));
+        }
+
+        std::string thread_name(std::uint32_t tid) const
+        {
+            std::lock_guard lock(mutex_);
+            return tid < buffers_.size() ? buffers_[tid]->name() : std::string();
+        }
+
+        std::uint32_t thread_count() const
+        {
+            std::lock_guard lock(mutex_);
+            return static_cast<std::uint32_t>(buffers_.size());
+        }
+
+    private:
+        Tracer() : start_ticks_(ticks()), start_time_(std::chrono::steady_clock::now()) {}
+
+        ThreadBuffer* register_thread()
+        {
+            std::lock_guard lock(mutex_);
+            const auto tid = static_cast<std::uint32_t>(buffers_.size());
+            buffers_.push_back(std::make_unique<ThreadBuffer>(tid, "thread " + std::to_string(tid)));
+            return buffers_.back().get();
+        }
+
+        // カウンタ1つが何ナノ秒か。作ってから今までの経過時間で割る（長く動かすほど正確になる）
+        double calibrate() const
+        {
+#if TRACE_HAS_TSC
+            const std::uint64_t now_ticks = ticks();
+            const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start_time_).count();
+            return now_ticks > start_ticks_ ? elapsed / static_cast<double>(now_ticks - start_ticks_) : 1.0;
+#else
+            using Period = std::chrono::steady_clock::period;
+            return 1e9 * Period::num / Period::den;
+#endif
+        }
+
+        std::atomic<bool>                          enabled_{ true };
+        std::uint64_t                              start_ticks_;
+        std::chrono::steady_clock::time_point      start_time_;
+        mutable std::mutex                         mutex_;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+    };
+
+    inline bool enabled() { return Tracer::instance().enabled(); }
+    inline void set_enabled(bool on) { Tracer::instance().set_enabled(on); }
+    inline void set_thread_name(std::string name) { Tracer::instance().set_thread_name(std::move(name)); }
+
+    // スコープの入口と出口で時刻を取る
+    class Scope
+    {
+    public:
+        explicit Scope(const Site& site)
+        {
+            if (enabled())
+            {
+                site_ = &site;
+                begin_ = ticks();
+            }
+        }
+
+        ~Scope()
+        {
+            if (site_ != nullptr)
+            {
+                const std::uint64_t end = ticks();
+                Tracer::instance().local_buffer().push(site_, begin_, end);
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const Site*   site_ = nullptr;
+        std::uint64_t begin_ = 0;
+    };
+
+    // JSON の文字列として書く（" と \ と制御文字をエスケープする。UTF-8 の文字はそのまま）
+    inline void append_json_string(std::string& out, std::string_view text)
+    {
+        out += '"';
+        for (const char c : text)
+        {
+            switch (c)
+            {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                    out += escaped;
+                }
+                else
+                {
+                    out += c;
+                }
+            }
+        }
+        out += '"';
+    }
+
+    // ナノ秒をマイクロ秒の小数（ナノ秒まで）で書く
+    inline void append_us(std::string& out, std::uint64_t ns)
+    {
+        out += std::to_string(ns / 1000);
+        const unsigned frac = static_cast<unsigned>(ns % 1000);
+        out += '.';
+        out += static_cast<char>('0' + frac / 100);
+        out += static_cast<char>('0' + frac / 10 % 10);
+        out += static_cast<char>('0' + frac % 10);
+    }
+
+    // --- Chrome / Perfetto の JSON（chrome://tracing や ui.perfetto.dev で開ける） ---
+    // 区間は "ph":"X"（開始と長さ）で書く。入れ子は時間の重なりから自動で組み立てられる
+    inline bool write_chrome_json(const char* path)
+    {
+        const Tracer& tracer = Tracer::instance();
+        std::string out = "{\"traceEvents\":[";
+        bool first = true;
+        auto begin_event = [&]()
+        {
+            out += first ? "\n{" : ",\n{";
+            first = false;
+        };
+        for (std::uint32_t tid = 0; tid < tracer.thread_count(); ++tid)
+        {
+            begin_event();
+            out += "\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(tid) + ",\"args\":{\"name\":";
+            append_json_string(out, tracer.thread_name(tid));
+            out += "}}";
+        }
+        for (const Span& s : tracer.collect())
+        {
+            // ts と dur の単位はマイクロ秒
+            begin_event();
+            out += "\"name\":";
+            append_json_string(out, s.site->name);
+            out += ",\"ph\":\"X\",\"pid\":1,\"tid\":" + std::to_string(s.tid) + ",\"ts\":";
+            append_us(out, s.begin_ns);
+            out += ",\"dur\":";
+            append_us(out, s.dur_ns);
+            out += '}';
+        }
+        out += "\n]}\n";
+
+        std::FILE* file = std::fopen(path, "wb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+        const bool ok = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+        return std::fclose(file) == 0 && ok;
+    }
+
+    // --- 小さなバイナリ形式 ---
+    //   "TRCB" / 版(u32) / 名前の数(u32) / 名前（長さ u32 + 中身）...
+    //   / 区間の数(u64) / 区間：名前の番号, tid, 前の区間からの開始の差（同じスレッドの中）, 長さ（すべて LEB128 の可変長整数）
+    // 区間はスレッド順・開始順に並んでいるので、開始は差で書くと1〜3バイトで済むことが多い
+    constexpr std::uint32_t BINARY_VERSION = 1;
+
+    inline void put_varint(std::string& out, std::uint64_t v)
+    {
+        while (v >= 0x80)
+        {
+            out += static_cast<char>((v & 0x7F) | 0x80);
+            v >>= 7;
+        }
+        out += static_cast<char>(v);
+    }
+
+    inline bool get_varint(const std::string& in, std::size_t& pos, std::uint64_t& v)
+    {
+        v = 0;
+        for (int shift = 0; pos < in.size() && shift < 64; shift += 7)
+        {
+            const auto byte = static_cast<std::uint8_t>(in[pos++]);
+            v |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline void put_u32(std::string& out, std::uint32_t v) { out.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+
+    inline bool write_binary(const char* path, const std::vector<Span>& spans)
+    {
+        std::unordered_map<const Site*, std::uint32_t> index;
+        std::vector<const Site*> sites;
+        for (const Span& s : spans)
+        {
+            if (index.try_emplace(s.site, static_cast<std::uint32_t>(sites.size())).second)
+            {
+                sites.push_back(s.site);
+            }
+        }
+
+        std::string out = "TRCB";
+        put_u32(out, BINARY_VERSION);
+        put_u32(out, static_cast<std::uint32_t>(sites.size()));
+        for (const Site* site : sites)
+        {
+            const auto n = static_cast<std::uint32_t>(std::strlen(site->name));
+            put_u32(out, n);
+            out.append(site->name, n);
+        }
+        put_varint(out, spans.size());
+        std::uint32_t tid = UINT32_MAX;
+        std::uint64_t prev = 0;
+        for (const Span& s : spans)
+        {
+            if (s.tid != tid)
+            {
+                tid = s.tid;
+                prev = 0;
+            }
+            put_varint(out, index[s.site]);
+            put_varint(out, s.tid);
+            put_varint(out, s.begin_ns - prev);
+            put_varint(out, s.dur_ns);
+            prev = s.begin_ns;
+        }
+
+        std::FILE* file = std::fopen(path, "wb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+        const bool ok = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+        return std::fclose(file) == 0 && ok;
+    }
+
+    // 今の記録を集めて書く（集めた spans と読み戻しを比べたいときは、上の版に渡す）
+    inline bool write_binary(const char* path)
+    {
+        return write_binary(path, Tracer::instance().collect());
+    }
+
+    // 読み戻した区間（名前は文字列で持つ）
+    struct LoadedSpan
+    {
+        std::uint32_t name;
+        std::uint32_t tid;
+        std::uint64_t begin_ns;
+        std::uint64_t dur_ns;
+    };
+
+    struct LoadedTrace
+    {
+        std::vector<std::string> names;
+        std::vector<LoadedSpan>  spans;
+    };
+
+    // 壊れたファイルや版の違うファイルなら false
+    inline bool read_binary(const char* path, LoadedTrace& trace)
+    {
+        std::FILE* file = std::fopen(path, "rb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+        std::string in;
+        char block[1 << 16];
+        for (std::size_t n; (n = std::fread(block, 1, sizeof(block), file)) > 0;)
+        {
+            in.append(block, n);
+        }
+        std::fclose(file);
+
+        auto get_u32 = [&](std::size_t& pos, std::uint32_t& v)
+        {
+            if (pos + sizeof(v) > in.size())
+            {
+                return false;
+            }
+            std::memcpy(&v, in.data() + pos, sizeof(v));
+            pos += sizeof(v);
+            return true;
+        };
+        std::size_t pos = 4;
+        std::uint32_t version = 0, name_count = 0;
+        if (in.compare(0, 4, "TRCB") != 0 || !get_u32(pos, version) || version != BINARY_VERSION || !get_u32(pos, name_count))
+        {
+            return false;
+        }
+        trace = {};
+        for (std::uint32_t i = 0; i < name_count; ++i)
+        {
+            std::uint32_t n = 0;
+            if (!get_u32(pos, n) || pos + n > in.size())
+            {
+                return false;
+            }
+            trace.names.emplace_back(in, pos, n);
+            pos += n;
+        }
+        std::uint64_t count = 0;
+        if (!get_varint(in, pos, count))
+        {
+            return false;
+        }
+        std::uint32_t tid = UINT32_MAX;
+        std::uint64_t prev = 0;
+        for (std::uint64_t i = 0; i < count; ++i)
+        {
+            std::uint64_t name, t, delta, dur;
+            if (!get_varint(in, pos, name) || !get_varint(in, pos, t) || !get_varint(in, pos, delta) || !get_varint(in, pos, dur)
+                || name >= trace.names.size())
+            {
+                return false;
+            }
+            if (t != tid)
+            {
+                tid = static_cast<std::uint32_t>(t);
+                prev = 0;
+            }
+            prev += delta;
+            trace.spans.push_back({ static_cast<std::uint32_t>(name), tid, prev, dur });
+        }
+        return true;
+    }
+}
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#if TRACE_ENABLED
+#define TRACE_SCOPE(name)                                                                                    \
+    static constexpr ::trace::Site TRACE_CONCAT(trace_site_, __LINE__){ name, __FILE__, __LINE__ };          \
+    const ::trace::Scope TRACE_CONCAT(trace_scope_, __LINE__)(TRACE_CONCAT(trace_site_, __LINE__))
+#else
+#define TRACE_SCOPE(name) static_cast<void>(0)
+#endif
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <string>
+#include <utility>
 
 // ✅ テンプレートで一本化
 template<typename T>
@@ -18,12 +19,13 @@ T clamp(T value, T min_val, T max_val)
 }
 
 // 汎用 swap（標準の std::swap も同じ仕組み）
+// コピーではなくムーブで入れ替える（ムーブは #26 で解説）
 template<typename T>
 void my_swap(T& a, T& b)
 {
-    T temp = a;
-    a = b;
-    b = temp;
+    T temp = std::move(a);
+    a = std::move(b);
+    b = std::move(temp);
 }
 
 int main()
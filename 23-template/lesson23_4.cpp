@@ -0,0 +1,336 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// --- トリビアルに再配置（relocate）できる型と、それを活かす vector ---
+// 「ムーブしてから元を破棄する」ことが「バイト列をそのまま memcpy する」ことと同じになる型を
+// トリビアルに再配置可能（trivially relocatable）と呼ぶ。
+// std::vector や std::unique_ptr は中身へのポインタを持つだけなので、場所を移してもそのまま使える。
+// そういう型なら、vector の拡張・erase・swap を要素ごとのムーブではなく memcpy / realloc で済ませられる
+
+// 既定ではトリビアルにコピーできる型（int, float, POD の構造体など）だけを対象にする
+template<typename T>
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+template<typename T>
+constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+// 実装を確認したうえで、自分の型に「再配置できる」と宣言するためのマクロ
+#define DECLARE_TRIVIALLY_RELOCATABLE(Type) \
+    template<> struct is_trivially_relocatable<Type> : std::true_type {}
+
+// src[0, n) を未初期化の dst へ移し、src 側は破棄済みの状態にする
+template<typename T>
+void relocate(T* dst, T* src, std::size_t n)
+{
+    if constexpr (is_trivially_relocatable_v<T>)
+    {
+        std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+    }
+    else if (dst < src)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            ::new (dst + i) T(std::move(src[i]));
+            src[i].~T();
+        }
+    }
+    else
+    {
+        for (std::size_t i = n; i-- > 0;) // 後ろから移す（範囲が重なっても壊さない）
+        {
+            ::new (dst + i) T(std::move(src[i]));
+            src[i].~T();
+        }
+    }
+}
+
+// 再配置を意識した swap。一時オブジェクトを作らずにバイトを入れ替える
+template<typename T>
+void my_swap(T& a, T& b)
+{
+    if constexpr (is_trivially_relocatable_v<T>)
+    {
+        alignas(T) unsigned char temp[sizeof(T)];
+        std::memcpy(temp, static_cast<void*>(&a), sizeof(T));
+        std::memcpy(static_cast<void*>(&a), static_cast<void*>(&b), sizeof(T));
+        std::memcpy(static_cast<void*>(&b), temp, sizeof(T));
+    }
+    else
+    {
+        T temp = std::move(a);
+        a = std::move(b);
+        b = std::move(temp);
+    }
+}
+
+// 再配置できる型では realloc で伸びる vector
+template<typename T>
+class RelocVector
+{
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc の境界を超える型には使えない");
+
+public:
+    RelocVector() = default;
+    RelocVector(const RelocVector&) = delete;
+    RelocVector& operator=(const RelocVector&) = delete;
+
+    ~RelocVector()
+    {
+        std::destroy_n(data_, size_);
+        std::free(data_);
+    }
+
+    std::size_t size() const { return size_; }
+    std::size_t capacity() const { return capacity_; }
+    T&          operator[](std::size_t i) { return data_[i]; }
+    const T&    operator[](std::size_t i) const { return data_[i]; }
+    T*          begin() { return data_; }
+    T*          end() { return data_ + size_; }
+
+    void reserve(std::size_t n)
+    {
+        if (n <= capacity_)
+        {
+            return;
+        }
+        if constexpr (is_trivially_relocatable_v<T>)
+        {
+            // 中身ごと realloc に任せる（その場で伸ばせればコピーすら起きない）
+            void* p = std::realloc(static_cast<void*>(data_), n * sizeof(T));
+            if (p == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+            data_ = static_cast<T*>(p);
+        }
+        else
+        {
+            T* fresh = static_cast<T*>(std::malloc(n * sizeof(T)));
+            if (fresh == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+            relocate(fresh, data_, size_);
+            std::free(data_);
+            data_ = fresh;
+        }
+        capacity_ = n;
+    }
+
+    // args が自分の要素を指していてもよい（v.emplace_back(v[0]) など）。
+    // 古い領域を手放すのは、新しい要素を作り終えてから
+    template<typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        if (size_ < capacity_)
+        {
+            T* p = ::new (data_ + size_) T(std::forward<Args>(args)...);
+            ++size_;
+            return *p;
+        }
+        const std::size_t grown = capacity_ == 0 ? 4 : capacity_ * 2;
+        if constexpr (is_trivially_relocatable_v<T>)
+        {
+            // 先に脇で作っておき、realloc のあとでバイトごと末尾へ移す
+            alignas(T) unsigned char temp[sizeof(T)];
+            T* made = ::new (static_cast<void*>(temp)) T(std::forward<Args>(args)...);
+            try
+            {
+                reserve(grown);
+            }
+            catch (...)
+            {
+                made->~T();
+                throw;
+            }
+            std::memcpy(static_cast<void*>(data_ + size_), temp, sizeof(T));
+        }
+        else
+        {
+            T* fresh = static_cast<T*>(std::malloc(grown * sizeof(T)));
+            if (fresh == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+            try
+            {
+                ::new (fresh + size_) T(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                std::free(fresh);
+                throw;
+            }
+            relocate(fresh, data_, size_);
+            std::free(data_);
+            data_ = fresh;
+            capacity_ = grown;
+        }
+        return data_[size_++];
+    }
+
+    // i 番目を取り除き、後ろを詰める（1回の memmove で済む）
+    void erase(std::size_t i)
+    {
+        if (i >= size_)
+        {
+            throw std::out_of_range("RelocVector::erase: 範囲外です");
+        }
+        data_[i].~T();
+        relocate(data_ + i, data_ + i + 1, size_ - i - 1);
+        --size_;
+    }
+
+    // i 番目を末尾の要素で埋めて取り除く（順序は変わるが O(1)）
+    void swap_erase(std::size_t i)
+    {
+        if (i >= size_)
+        {
+            throw std::out_of_range("RelocVector::swap_erase: 範囲外です");
+        }
+        data_[i].~T();
+        if (i != size_ - 1)
+        {
+            relocate(data_ + i, data_ + size_ - 1, 1);
+        }
+        --size_;
+    }
+
+private:
+    T*          data_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t capacity_ = 0;
+};
+
+// ムーブが何回起きたかを数える
+static std::size_t g_moves = 0;
+
+struct Stats
+{
+    int attack;
+    int defense;
+};
+
+// lesson26_3 の EnemyData に近い型
+// ⚠️ libstdc++ の std::string は短い文字列を自分の内側に置き、そこへのポインタを持つので
+//    memcpy で移すと壊れる。再配置可能と宣言する型には std::string を入れないこと
+struct EnemyData
+{
+    int                    id;
+    std::vector<int>       damage_log;
+    std::unique_ptr<Stats> stats;
+
+    EnemyData(int i, int log_size)
+        : id(i)
+        , damage_log(log_size, 10)
+        , stats(std::make_unique<Stats>(Stats{ 10, 5 }))
+    {}
+
+    EnemyData(EnemyData&& other) noexcept
+        : id(other.id)
+        , damage_log(std::move(other.damage_log))
+        , stats(std::move(other.stats))
+    {
+        ++g_moves;
+    }
+
+    EnemyData& operator=(EnemyData&& other) noexcept
+    {
+        id = other.id;
+        damage_log = std::move(other.damage_log);
+        stats = std::move(other.stats);
+        ++g_moves;
+        return *this;
+    }
+};
+
+// std::vector と std::unique_ptr はどちらも中身へのポインタだけを持つので再配置できる
+DECLARE_TRIVIALLY_RELOCATABLE(EnemyData);
+
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+    constexpr int N = 1'000'000;
+
+    // 要素を作る時間（vector と unique_ptr の確保）はどちらも同じなので、計測から外す。
+    // 計るのは「先頭を ERASES 回消す」と「容量を倍にする」の2つ、つまり要素を移す時間だけ
+    constexpr int ERASES = 20;
+
+    // --- std::vector：拡張も erase も全要素をムーブする ---
+    std::vector<EnemyData> std_list;
+    std_list.reserve(N);
+    for (int i = 0; i < N; ++i)
+    {
+        std_list.emplace_back(i, 1);
+    }
+    g_moves = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < ERASES; ++i)
+    {
+        std_list.erase(std_list.begin()); // 後ろの全要素がムーブ代入される
+    }
+    std_list.reserve(std_list.capacity() * 2);
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    std::cout << "std::vector: " << us << "us / ムーブ " << g_moves << "回" << std::endl;
+
+    // --- RelocVector：realloc と memmove だけで移す ---
+    RelocVector<EnemyData> reloc_list;
+    reloc_list.reserve(N);
+    for (int i = 0; i < N; ++i)
+    {
+        reloc_list.emplace_back(i, 1);
+    }
+    g_moves = 0;
+    start = Clock::now();
+    for (int i = 0; i < ERASES; ++i)
+    {
+        reloc_list.erase(0);
+    }
+    reloc_list.reserve(reloc_list.capacity() * 2);
+    us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    std::cout << "RelocVector: " << us << "us / ムーブ " << g_moves << "回" << std::endl;
+    std::cout << "先頭の id: " << reloc_list[0].id << " 攻撃力: " << reloc_list[0].stats->attack << std::endl;
+
+    // --- 自分の要素を渡しても、拡張で壊れない ---
+    RelocVector<EnemyData> small;
+    small.emplace_back(7, 2);
+    while (small.size() < small.capacity())
+    {
+        small.emplace_back(0, 0);
+    }
+    small.emplace_back(std::move(small[0])); // 満杯なので、ここで拡張が起きる
+    RelocVector<std::string> names;
+    names.emplace_back("スライムより少し強いゴブリン"); // 短い文字列最適化に収まらない長さ
+    for (int i = 0; i < 3; ++i)
+    {
+        names.emplace_back("x");
+    }
+    names.emplace_back(names[0]); // 満杯でコピー元が自分の要素
+    std::cout << "自分の要素を追加: id=" << small[small.size() - 1].id << " (" << small[small.size() - 1].damage_log.size()
+              << "件) / " << names[names.size() - 1] << std::endl;
+
+    // --- my_swap ---
+    EnemyData a(1, 3);
+    EnemyData b(2, 5);
+    g_moves = 0;
+    my_swap(a, b); // 再配置可能なのでムーブは起きない
+    std::cout << "\nswap 後: a.id=" << a.id << " (" << a.damage_log.size() << "件) / b.id=" << b.id
+              << " (" << b.damage_log.size() << "件) ムーブ " << g_moves << "回" << std::endl;
+
+    std::string hero = "勇者";
+    std::string mage = "魔法使い";
+    my_swap(hero, mage); // std::string は通常のムーブで入れ替える
+    std::cout << hero << " / " << mage << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,447 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+// --- 分岐なしの clamp / 飽和加算・減算を、HP の列にまとめてかける ---
+// lesson23_2 の clamp や lesson13_1 の Player::Damage / Heal は、1つの値を if で直していた。
+// ここでは全員の HP を1本の配列（列）に並べ、
+//   damage(hp, amount)          … hp = max(hp - amount, 0)         （引き算は型の範囲で飽和）
+//   heal(hp, amount, max_hp)    … hp = min(hp + amount, max_hp)    （足し算は型の範囲で飽和）
+//   clamp(values, lo, hi)       … 全要素を [lo, hi] に収める
+// を1回のループで済ませる。int16 / int32 / float に対応し、
+// AVX2 があれば 256 ビット、SSE4.1 なら 128 ビットずつ、それ以外は1個ずつ計算する。
+// 「飽和」とは、型の最大値を超えたら最大値に、最小値を下回ったら最小値に張り付くこと
+// （int の足し算があふれて負の HP になる、という事故が起きない）
+
+// --- 1個ずつ計算する版（端数の処理と、結果の確認に使う） ---
+template<typename T>
+T add_sat(T a, T b)
+{
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        return a + b; // 浮動小数点はあふれると inf になるだけ
+    }
+    else
+    {
+        T r;
+        if (__builtin_add_overflow(a, b, &r))
+        {
+            r = b < 0 ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+        }
+        return r;
+    }
+}
+
+template<typename T>
+T sub_sat(T a, T b)
+{
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        return a - b;
+    }
+    else
+    {
+        T r;
+        if (__builtin_sub_overflow(a, b, &r))
+        {
+            r = b < 0 ? std::numeric_limits<T>::max() : std::numeric_limits<T>::min();
+        }
+        return r;
+    }
+}
+
+// SIMD の min / max と同じ規則の min / max。_mm_max_ps(a, b) は「a > b なら a、それ以外は b」なので、
+// どちらかが NaN なら2つ目を返す。std::max(a, b) は a が NaN なら a を返すので、
+// 端数をこちらで計算しないと、同じ NaN でも配列のどこにあるかで結果が変わってしまう
+// （clamp(values, lo, hi) では NaN は lo になる）
+template<typename T>
+T max_lane(T a, T b)
+{
+    return a > b ? a : b;
+}
+
+template<typename T>
+T min_lane(T a, T b)
+{
+    return a < b ? a : b;
+}
+
+// --- 型ごとの SIMD 命令をまとめた表 ---
+// Lanes<T>::N 個ずつ読み書きし、adds / subs / min / max を同じ名前で呼べるようにする。
+// 対応していない型・環境では ENABLED = false になり、1個ずつの版だけが使われる
+template<typename T>
+struct Lanes
+{
+    static constexpr bool ENABLED = false;
+};
+
+#if defined(__AVX2__)
+
+template<>
+struct Lanes<std::int16_t>
+{
+    static constexpr bool ENABLED = true;
+    static constexpr std::size_t N = 16;
+    using reg = __m256i;
+    static reg  load(const std::int16_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(std::int16_t* p, reg v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static reg  set1(std::int16_t x) { return _mm256_set1_epi16(x); }
+    static reg  adds(reg a, reg b) { return _mm256_adds_epi16(a, b); } // 16 ビットには飽和加算の命令がある
+    static reg  subs(reg a, reg b) { return _mm256_subs_epi16(a, b); }
+    static reg  min(reg a, reg b) { return _mm256_min_epi16(a, b); }
+    static reg  max(reg a, reg b) { return _mm256_max_epi16(a, b); }
+};
+
+template<>
+struct Lanes<std::int32_t>
+{
+    static constexpr bool ENABLED = true;
+    static constexpr std::size_t N = 8;
+    using reg = __m256i;
+    static reg  load(const std::int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(std::int32_t* p, reg v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static reg  set1(std::int32_t x) { return _mm256_set1_epi32(x); }
+
+    // 32 ビットには飽和加算の命令がないので、あふれた要素だけを差し替える。
+    // a と b の符号が同じで、結果の符号だけが違えばあふれている。
+    // あふれた先は a の符号で決まる（a >= 0 なら INT32_MAX、a < 0 なら INT32_MIN）
+    static reg adds(reg a, reg b)
+    {
+        const reg sum = _mm256_add_epi32(a, b);
+        const reg overflow = _mm256_and_si256(_mm256_xor_si256(a, sum), _mm256_xor_si256(b, sum));
+        return blend_saturated(sum, a, overflow);
+    }
+
+    // 引き算は a と b の符号が違い、結果の符号が a と違えばあふれている
+    static reg subs(reg a, reg b)
+    {
+        const reg diff = _mm256_sub_epi32(a, b);
+        const reg overflow = _mm256_and_si256(_mm256_xor_si256(a, b), _mm256_xor_si256(a, diff));
+        return blend_saturated(diff, a, overflow);
+    }
+
+    static reg min(reg a, reg b) { return _mm256_min_epi32(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_epi32(a, b); }
+
+private:
+    static reg blend_saturated(reg result, reg a, reg overflow)
+    {
+        // (a >> 31) ^ 0x7fffffff は a >= 0 なら INT32_MAX、a < 0 なら INT32_MIN
+        const reg saturated = _mm256_xor_si256(_mm256_srai_epi32(a, 31), _mm256_set1_epi32(std::numeric_limits<std::int32_t>::max()));
+        // blendv は各バイトの最上位ビットで選ぶので、符号ビットを32ビット全体に広げてから使う
+        return _mm256_blendv_epi8(result, saturated, _mm256_srai_epi32(overflow, 31));
+    }
+};
+
+template<>
+struct Lanes<float>
+{
+    static constexpr bool ENABLED = true;
+    static constexpr std::size_t N = 8;
+    using reg = __m256;
+    static reg  load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, reg v) { _mm256_storeu_ps(p, v); }
+    static reg  set1(float x) { return _mm256_set1_ps(x); }
+    static reg  adds(reg a, reg b) { return _mm256_add_ps(a, b); }
+    static reg  subs(reg a, reg b) { return _mm256_sub_ps(a, b); }
+    static reg  min(reg a, reg b) { return _mm256_min_ps(a, b); }
+    static reg  max(reg a, reg b) { return _mm256_max_ps(a, b); }
+};
+
+#elif defined(__SSE4_1__)
+
+template<>
+struct Lanes<std::int16_t>
+{
+    static constexpr bool ENABLED = true;
+    static constexpr std::size_t N = 8;
+    using reg = __m128i;
+    static reg  load(const std::int16_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(std::int16_t* p, reg v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static reg  set1(std::int16_t x) { return _mm_set1_epi16(x); }
+    static reg  adds(reg a, reg b) { return _mm_adds_epi16(a, b); }
+    static reg  subs(reg a, reg b) { return _mm_subs_epi16(a, b); }
+    static reg  min(reg a, reg b) { return _mm_min_epi16(a, b); }
+    static reg  max(reg a, reg b) { return _mm_max_epi16(a, b); }
+};
+
+template<>
+struct Lanes<std::int32_t>
+{
+    static constexpr bool ENABLED = true;
+    static constexpr std::size_t N = 4;
+    using reg = __m128i;
+    static reg  load(const std::int32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(std::int32_t* p, reg v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static reg  set1(std::int32_t x) { return _mm_set1_epi32(x); }
+
+    // 考え方は AVX2 版と同じ
+    static reg adds(reg a, reg b)
+    {
+        const reg sum = _mm_add_epi32(a, b);
+        return blend_saturated(sum, a, _mm_and_si128(_mm_xor_si128(a, sum), _mm_xor_si128(b, sum)));
+    }
+
+    static reg subs(reg a, reg b)
+    {
+        const reg diff = _mm_sub_epi32(a, b);
+        return blend_saturated(diff, a, _mm_and_si128(_mm_xor_si128(a, b), _mm_xor_si128(a, diff)));
+    }
+
+    static reg min(reg a, reg b) { return _mm_min_epi32(a, b); }
+    static reg max(reg a, reg b) { return _mm_max_epi32(a, b); }
+
+private:
+    static reg blend_saturated(reg result, reg a, reg overflow)
+    {
+        const reg saturated = _mm_xor_si128(_mm_srai_epi32(a, 31), _mm_set1_epi32(std::numeric_limits<std::int32_t>::max()));
+        return _mm_blendv_epi8(result, saturated, _mm_srai_epi32(overflow, 31));
+    }
+};
+
+template<>
+struct Lanes<float>
+{
+    static constexpr bool ENABLED = true;
+    static constexpr std::size_t N = 4;
+    using reg = __m128;
+    static reg  load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, reg v) { _mm_storeu_ps(p, v); }
+    static reg  set1(float x) { return _mm_set1_ps(x); }
+    static reg  adds(reg a, reg b) { return _mm_add_ps(a, b); }
+    static reg  subs(reg a, reg b) { return _mm_sub_ps(a, b); }
+    static reg  min(reg a, reg b) { return _mm_min_ps(a, b); }
+    static reg  max(reg a, reg b) { return _mm_max_ps(a, b); }
+};
+
+#endif
+
+// --- 列全体にかける関数 ---
+// 3つとも「SIMD で N 個ずつ → 残りを1個ずつ」という同じ形をしている
+
+template<typename T>
+void clamp(std::span<T> values, T lo, T hi)
+{
+    std::size_t i = 0;
+    if constexpr (Lanes<T>::ENABLED)
+    {
+        using L = Lanes<T>;
+        const auto vlo = L::set1(lo);
+        const auto vhi = L::set1(hi);
+        for (; i + L::N <= values.size(); i += L::N)
+        {
+            L::store(values.data() + i, L::min(L::max(L::load(values.data() + i), vlo), vhi));
+        }
+    }
+    for (; i < values.size(); ++i)
+    {
+        values[i] = min_lane(max_lane(values[i], lo), hi);
+    }
+}
+
+// hp[i] = max(hp[i] - amount[i], 0)
+template<typename T>
+void damage(std::span<T> hp, std::span<const T> amount)
+{
+    const std::size_t n = std::min(hp.size(), amount.size());
+    std::size_t i = 0;
+    if constexpr (Lanes<T>::ENABLED)
+    {
+        using L = Lanes<T>;
+        const auto zero = L::set1(T{ 0 });
+        for (; i + L::N <= n; i += L::N)
+        {
+            L::store(hp.data() + i, L::max(L::subs(L::load(hp.data() + i), L::load(amount.data() + i)), zero));
+        }
+    }
+    for (; i < n; ++i)
+    {
+        hp[i] = max_lane(sub_sat(hp[i], amount[i]), T{ 0 });
+    }
+}
+
+// hp[i] = min(hp[i] + amount[i], max_hp[i])
+template<typename T>
+void heal(std::span<T> hp, std::span<const T> amount, std::span<const T> max_hp)
+{
+    const std::size_t n = std::min({ hp.size(), amount.size(), max_hp.size() });
+    std::size_t i = 0;
+    if constexpr (Lanes<T>::ENABLED)
+    {
+        using L = Lanes<T>;
+        for (; i + L::N <= n; i += L::N)
+        {
+            L::store(hp.data() + i, L::min(L::adds(L::load(hp.data() + i), L::load(amount.data() + i)), L::load(max_hp.data() + i)));
+        }
+    }
+    for (; i < n; ++i)
+    {
+        hp[i] = min_lane(add_sat(hp[i], amount[i]), max_hp[i]);
+    }
+}
+
+// --- 確認：あふれやすい値を混ぜた乱数で、SIMD 版と1個ずつの版を比べる ---
+template<typename T>
+bool check_against_scalar(const char* name)
+{
+    std::mt19937 rng(7);
+    constexpr std::size_t COUNT = 1003; // SIMD の幅で割り切れない数にして端数の処理も通す
+    std::vector<T> hp(COUNT), amount(COUNT), max_hp(COUNT);
+    const T lo = std::numeric_limits<T>::lowest();
+    const T hi = std::numeric_limits<T>::max();
+    std::vector<T> edges = { lo, static_cast<T>(lo + 1), T{ -1 }, T{ 0 }, T{ 1 }, static_cast<T>(hi - 1), hi };
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        edges.push_back(std::numeric_limits<T>::quiet_NaN());
+        edges.push_back(std::numeric_limits<T>::infinity());
+        edges.push_back(-std::numeric_limits<T>::infinity());
+    }
+    auto pick = [&]
+    {
+        if (rng() % 4 == 0)
+        {
+            return edges[rng() % edges.size()];
+        }
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            return std::uniform_real_distribution<T>(-1000, 1000)(rng);
+        }
+        else
+        {
+            return std::uniform_int_distribution<T>(lo, hi)(rng);
+        }
+    };
+    for (std::size_t i = 0; i < COUNT; ++i)
+    {
+        hp[i] = pick();
+        amount[i] = pick();
+        max_hp[i] = pick();
+    }
+
+    std::vector<T> expected = hp;
+    std::vector<T> actual = hp;
+    for (std::size_t i = 0; i < COUNT; ++i)
+    {
+        expected[i] = max_lane(sub_sat(expected[i], amount[i]), T{ 0 });
+        expected[i] = min_lane(add_sat(expected[i], amount[i]), max_hp[i]);
+        expected[i] = min_lane(max_lane(expected[i], T{ -50 }), T{ 50 });
+    }
+    damage<T>(actual, amount);
+    heal<T>(actual, amount, max_hp);
+    clamp<T>(actual, T{ -50 }, T{ 50 });
+
+    // NaN どうしも同じとみなして比べる
+    auto same = [](const std::vector<T>& x, const std::vector<T>& y)
+    {
+        return std::equal(x.begin(), x.end(), y.begin(), y.end(), [](T a, T b) { return a == b || (a != a && b != b); });
+    };
+    bool ok = same(expected, actual);
+
+    // clamp だけも確かめる。damage を通すと NaN は消えるので、端の値を1つずつ、
+    // SIMD で計算される先頭と、1個ずつ計算される末尾の両方に置く
+    for (const T edge : edges)
+    {
+        std::vector<T> clamp_actual = hp;
+        clamp_actual.front() = edge;
+        clamp_actual.back() = edge;
+        std::vector<T> clamp_expected = clamp_actual;
+        for (T& v : clamp_expected)
+        {
+            v = min_lane(max_lane(v, T{ -50 }), T{ 50 });
+        }
+        clamp<T>(clamp_actual, T{ -50 }, T{ 50 });
+        ok &= same(clamp_expected, clamp_actual);
+    }
+    std::cout << "  " << name << ": " << (ok ? "一致" : "不一致!") << "\n";
+    return ok;
+}
+
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+#if defined(__AVX2__)
+    std::cout << "AVX2 で計算します\n";
+#elif defined(__SSE4_1__)
+    std::cout << "SSE4.1 で計算します\n";
+#else
+    std::cout << "SIMD なし（1個ずつ）で計算します\n";
+#endif
+
+    std::cout << "1個ずつの版との比較:\n";
+    bool ok = check_against_scalar<std::int16_t>("int16");
+    ok &= check_against_scalar<std::int32_t>("int32");
+    ok &= check_against_scalar<float>("float");
+
+    // lesson23_2 と同じ使い方（1つの値を範囲に収める）も、長さ1の列として書ける
+    int player_hp = 120;
+    clamp(std::span(&player_hp, 1), 0, 100);
+    std::cout << "\nHP: " << player_hp << "\n"; // 100
+
+    // --- 100万体にダメージと回復を毎ティックかける ---
+    constexpr std::size_t ENTITIES = 1'000'000;
+    constexpr int TICKS = 100;
+    std::mt19937 rng(1);
+    std::vector<std::int32_t> max_hp(ENTITIES), dmg(ENTITIES), regen(ENTITIES);
+    for (std::size_t i = 0; i < ENTITIES; ++i)
+    {
+        max_hp[i] = 100 + static_cast<std::int32_t>(rng() % 900);
+        dmg[i] = static_cast<std::int32_t>(rng() % 40);
+        regen[i] = static_cast<std::int32_t>(rng() % 30);
+    }
+
+    // Player::Damage / Heal と同じ書き方（if で1体ずつ直す）
+    std::vector<std::int32_t> hp_branch = max_hp;
+    auto start = Clock::now();
+    for (int t = 0; t < TICKS; ++t)
+    {
+        for (std::size_t i = 0; i < ENTITIES; ++i)
+        {
+            hp_branch[i] -= dmg[i];
+            if (hp_branch[i] < 0)
+                hp_branch[i] = 0;
+        }
+        for (std::size_t i = 0; i < ENTITIES; ++i)
+        {
+            hp_branch[i] += regen[i];
+            if (hp_branch[i] > max_hp[i])
+                hp_branch[i] = max_hp[i];
+        }
+    }
+    const auto branch_us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+    std::vector<std::int32_t> hp_simd = max_hp;
+    start = Clock::now();
+    for (int t = 0; t < TICKS; ++t)
+    {
+        damage<std::int32_t>(hp_simd, dmg);
+        heal<std::int32_t>(hp_simd, regen, max_hp);
+    }
+    const auto simd_us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+    ok &= hp_branch == hp_simd;
+    std::cout << ENTITIES << "体 x " << TICKS << "ティック\n";
+    std::cout << "  if で1体ずつ: " << branch_us / 1000 << "ms\n";
+    std::cout << "  列にまとめて: " << simd_us / 1000 << "ms（結果は"
+              << (hp_branch == hp_simd ? "一致" : "不一致!") << "）\n";
+
+    // 回復量が大きすぎても、int16 なら 32767 に張り付いてから最大 HP に収まる
+    std::vector<std::int16_t> small_hp = { 30000, 100, 0 };
+    const std::vector<std::int16_t> big_heal = { 10000, 10000, 10000 };
+    const std::vector<std::int16_t> small_max = { 32000, 500, 32767 };
+    heal<std::int16_t>(small_hp, big_heal, small_max);
+    std::cout << "int16 の回復: " << small_hp[0] << ", " << small_hp[1] << ", " << small_hp[2] << "\n";
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,257 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <string>
+
+// --- フレーム予算つきタスクスケジューラ ---
+// lesson25_2 の Task キューを発展させ、1フレームに使える時間（予算）の中で
+// 優先度の高いタスクから処理し、あふれた低優先度タスクは次フレーム以降に回す
+
+using Clock = std::chrono::steady_clock;
+using Micro = std::chrono::microseconds;
+
+enum class Priority
+{
+    Critical, // 予算を超えても必ずそのフレームで実行（入力・物理など）
+    High,
+    Normal,
+    Low,      // AI再計画、キャッシュ再構築など
+    Count
+};
+
+constexpr std::size_t PRIORITY_COUNT = static_cast<std::size_t>(Priority::Count);
+
+// 分割実行できるタスクは step() が false を返すと「まだ続きがある」ことを表す
+// 1回の step() はおおむね estimate 以内に終わるように作る
+struct Task
+{
+    std::string           name;
+    Priority              priority;
+    Micro                 estimate; // 1回分の見積もり時間
+    std::function<bool()> step;     // true: 完了 / false: 次フレームで続きを実行
+    int                   deferred_frames = 0;
+};
+
+// 先送りの理由
+enum class DeferReason
+{
+    BudgetExhausted, // 予算を使い切っていたので着手しなかった
+    EstimateTooLarge, // 残り予算では見積もりが収まらなかった
+    Sliced,          // 分割タスクの続きを次フレームへ回した
+    Count
+};
+
+constexpr std::size_t DEFER_REASON_COUNT = static_cast<std::size_t>(DeferReason::Count);
+
+const char* to_string(DeferReason reason)
+{
+    switch (reason)
+    {
+    case DeferReason::BudgetExhausted:  return "予算切れ";
+    case DeferReason::EstimateTooLarge: return "見積もり超過";
+    case DeferReason::Sliced:           return "分割継続";
+    default:                            return "?";
+    }
+}
+
+// 1フレーム分の実行結果
+struct FrameReport
+{
+    int   executed = 0;
+    int   completed = 0;
+    Micro used{ 0 };
+    Micro deferred_estimate{ 0 }; // 先送りした仕事量（見積もりの合計）
+    std::array<int, DEFER_REASON_COUNT> deferred{};
+
+    int deferred_total() const
+    {
+        int total = 0;
+        for (int n : deferred)
+        {
+            total += n;
+        }
+        return total;
+    }
+};
+
+class FrameScheduler
+{
+public:
+    // aging_frames: 何フレーム先送りされたら優先度を1段上げるか（飢餓防止）
+    explicit FrameScheduler(Micro budget, int aging_frames = 4)
+        : budget_(budget)
+        , aging_frames_(aging_frames)
+    {}
+
+    void submit(Task task)
+    {
+        queues_[index(task.priority)].push(std::move(task));
+    }
+
+    bool empty() const
+    {
+        for (const auto& q : queues_)
+        {
+            if (!q.empty())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 1フレーム分の処理を行う
+    FrameReport run_frame()
+    {
+        FrameReport report;
+        const auto frame_start = Clock::now();
+        std::array<std::queue<Task>, PRIORITY_COUNT> next_frame;
+        bool ran_background = false; // このフレームで Critical 以外を1つでも実行したか
+
+        for (std::size_t p = 0; p < PRIORITY_COUNT; ++p)
+        {
+            auto& q = queues_[p];
+            while (!q.empty())
+            {
+                Task task = std::move(q.front());
+                q.pop();
+
+                const Micro used = elapsed_since(frame_start);
+                const Micro remaining = budget_ - used;
+                const bool critical = task.priority == Priority::Critical;
+
+                if (!critical && remaining <= Micro{ 0 })
+                {
+                    defer(std::move(task), DeferReason::BudgetExhausted, report, next_frame);
+                    continue;
+                }
+                // 残り予算に収まらない見積もりは、このフレームでは着手しない
+                // ただし予算より大きいタスクはいつまでも収まらないので、フレーム最初の1件として実行する
+                const bool oversized = task.estimate > budget_ && !ran_background;
+                if (!critical && task.estimate > remaining && !oversized)
+                {
+                    defer(std::move(task), DeferReason::EstimateTooLarge, report, next_frame);
+                    continue;
+                }
+
+                ran_background = ran_background || !critical;
+                ++report.executed;
+                if (task.step())
+                {
+                    ++report.completed;
+                }
+                else
+                {
+                    defer(std::move(task), DeferReason::Sliced, report, next_frame);
+                }
+            }
+        }
+
+        // 先送りしたタスクを元のキューに戻す（優先度ごとに入れた順を保つ）
+        for (std::size_t p = 0; p < PRIORITY_COUNT; ++p)
+        {
+            while (!next_frame[p].empty())
+            {
+                queues_[p].push(std::move(next_frame[p].front()));
+                next_frame[p].pop();
+            }
+        }
+
+        report.used = elapsed_since(frame_start);
+        return report;
+    }
+
+private:
+    static std::size_t index(Priority p) { return static_cast<std::size_t>(p); }
+
+    static Micro elapsed_since(Clock::time_point start)
+    {
+        return std::chrono::duration_cast<Micro>(Clock::now() - start);
+    }
+
+    void defer(Task task, DeferReason reason, FrameReport& report,
+               std::array<std::queue<Task>, PRIORITY_COUNT>& next_frame)
+    {
+        ++report.deferred[static_cast<std::size_t>(reason)];
+        report.deferred_estimate += task.estimate;
+
+        // 待たされ続けたタスクは優先度を上げる（Critical までは上げない）
+        ++task.deferred_frames;
+        if (task.deferred_frames >= aging_frames_ && task.priority > Priority::High)
+        {
+            task.priority = static_cast<Priority>(index(task.priority) - 1);
+            task.deferred_frames = 0;
+        }
+        next_frame[index(task.priority)].push(std::move(task));
+    }
+
+    Micro budget_;
+    int   aging_frames_;
+    std::array<std::queue<Task>, PRIORITY_COUNT> queues_;
+};
+
+// 指定時間だけCPUを使う（重い処理のイメージ）
+void busy_work(Micro duration)
+{
+    const auto end = Clock::now() + duration;
+    while (Clock::now() < end)
+    {
+    }
+}
+
+// 決まった時間の処理を1回で終えるタスク
+Task make_task(std::string name, Priority priority, Micro cost)
+{
+    return { std::move(name), priority, cost, [cost]() { busy_work(cost); return true; } };
+}
+
+// 全体で slices 回に分けて実行するタスク
+Task make_sliced_task(std::string name, Priority priority, Micro slice_cost, int slices)
+{
+    auto remaining = std::make_shared<int>(slices);
+    return { std::move(name), priority, slice_cost, [slice_cost, remaining]()
+        {
+            busy_work(slice_cost);
+            return --*remaining == 0;
+        } };
+}
+
+int main()
+{
+    FrameScheduler scheduler(Micro{ 2000 }); // 1フレームあたり 2ms
+
+    // バースト的に積まれたバックグラウンド処理
+    scheduler.submit(make_sliced_task("AI再計画", Priority::Low, Micro{ 600 }, 5));
+    scheduler.submit(make_task("経路キャッシュ再構築", Priority::Low, Micro{ 1500 }));
+    scheduler.submit(make_task("敵A の攻撃", Priority::High, Micro{ 300 }));
+    scheduler.submit(make_task("敵B の移動", Priority::Normal, Micro{ 400 }));
+    scheduler.submit(make_task("プレイヤーの防御", Priority::Critical, Micro{ 200 }));
+
+    int frame = 0;
+    while (!scheduler.empty())
+    {
+        // 毎フレーム入力処理が入ってくるイメージ
+        scheduler.submit(make_task("入力処理", Priority::Critical, Micro{ 100 }));
+
+        FrameReport r = scheduler.run_frame();
+        std::cout << "フレーム" << frame++ << ": 実行 " << r.executed
+                  << " / 完了 " << r.completed
+                  << " / 使用 " << r.used.count() << "us"
+                  << " / 先送り " << r.deferred_total()
+                  << " (約" << r.deferred_estimate.count() << "us分)";
+        for (std::size_t i = 0; i < DEFER_REASON_COUNT; ++i)
+        {
+            if (r.deferred[i] > 0)
+            {
+                std::cout << " " << to_string(static_cast<DeferReason>(i)) << ":" << r.deferred[i];
+            }
+        }
+        std::cout << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,489 @@
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// --- フローフィールド経路探索 ---
+// lesson25_2 の BFS の骨格を、実際のグリッドマップで動くものにする
+// ゴール（プレイヤー）側から1回だけ探索して「各マスでどちらへ進めばよいか」を求めておけば、
+// 何千体の敵がいても、それぞれは自分のマスの矢印を読むだけで追いかけられる
+
+constexpr std::uint8_t  WALL        = 0xFF; // 通れないマス
+constexpr std::uint32_t UNREACHABLE = std::numeric_limits<std::uint32_t>::max();
+
+// コストをマスごとに1バイトで持つ平らな配列（1: 平地、数値が大きいほど通りにくい）
+struct Grid
+{
+    int width;
+    int height;
+    std::vector<std::uint8_t> cost;
+
+    Grid(int w, int h) : width(w), height(h), cost(static_cast<std::size_t>(w) * h, 1) {}
+
+    std::uint32_t index(int x, int y) const { return static_cast<std::uint32_t>(y * width + x); }
+    std::size_t   size() const { return cost.size(); }
+};
+
+// 訪問済みフラグを1マス1ビットで持つ
+class Bitset
+{
+public:
+    void reset(std::size_t bits)
+    {
+        words_.assign((bits + 63) / 64, 0);
+    }
+
+    bool test(std::uint32_t i) const { return (words_[i >> 6] >> (i & 63)) & 1u; }
+    void set(std::uint32_t i) { words_[i >> 6] |= std::uint64_t{ 1 } << (i & 63); }
+
+    // 初めて立てたときだけ true を返す（1スレッドだけで使う版）
+    bool try_set(std::uint32_t i)
+    {
+        if (test(i))
+        {
+            return false;
+        }
+        set(i);
+        return true;
+    }
+
+    // try_set の、複数スレッドから同時に呼べる版（ロック付きの fetch_or なので、1スレッドなら try_set のほうが速い）
+    bool claim(std::uint32_t i)
+    {
+        const std::uint64_t bit = std::uint64_t{ 1 } << (i & 63);
+        std::atomic_ref<std::uint64_t> word(words_[i >> 6]);
+        return (word.fetch_or(bit, std::memory_order_relaxed) & bit) == 0;
+    }
+
+private:
+    std::vector<std::uint64_t> words_;
+};
+
+// 各マスで進むべき方向
+enum Direction : std::uint8_t
+{
+    Right, Left, Down, Up,
+    Goal,    // ゴールのマス
+    Blocked, // 壁、またはたどり着けないマス
+};
+
+constexpr int DX[4] = { 1, -1, 0, 0 };
+constexpr int DY[4] = { 0, 0, 1, -1 };
+
+// BFS の1段ごとに同じ仕事を全スレッドで分担するためのワーカー。
+// スレッドは最初に1回だけ作り、段ごとに barrier で「開始」と「終了」をそろえる
+class LevelWorkers
+{
+public:
+    explicit LevelWorkers(int threads) : start_(threads), done_(threads)
+    {
+        for (int t = 1; t < threads; ++t)
+        {
+            workers_.emplace_back([this, t]()
+                {
+                    for (;;)
+                    {
+                        start_.arrive_and_wait();
+                        if (stopping_)
+                        {
+                            return;
+                        }
+                        job_(t);
+                        done_.arrive_and_wait();
+                    }
+                });
+        }
+    }
+
+    ~LevelWorkers()
+    {
+        stopping_ = true; // barrier を通るので、ワーカーからも見える
+        start_.arrive_and_wait();
+    }
+
+    LevelWorkers(const LevelWorkers&) = delete;
+    LevelWorkers& operator=(const LevelWorkers&) = delete;
+
+    int size() const { return static_cast<int>(workers_.size()) + 1; }
+
+    // job(スレッド番号) を全スレッドで1回ずつ呼び、全員が終わるまで待つ（呼んだスレッドが 0 番）
+    void run(std::function<void(int)> job)
+    {
+        job_ = std::move(job);
+        start_.arrive_and_wait();
+        job_(0);
+        done_.arrive_and_wait();
+    }
+
+private:
+    std::barrier<>             start_;
+    std::barrier<>             done_;
+    std::function<void(int)>   job_;
+    bool                       stopping_ = false;
+    std::vector<std::jthread>  workers_; // 最後に宣言する（barrier より先に join される）
+};
+
+class FlowField
+{
+public:
+    explicit FlowField(const Grid& grid) : grid_(grid) {}
+
+    // 全マスのコストを1として BFS で距離を求める
+    // threads > 1 のときは、フロンティア（同じ距離のマスの集まり）を分担して広げる
+    void build_bfs(const std::vector<std::uint32_t>& goals, int threads = 1)
+    {
+        begin(goals);
+        for (std::uint32_t g : frontier_)
+        {
+            visited_.set(g);
+        }
+        std::uint32_t level = 0;
+        parallel_levels_ = 0;
+        if (threads > 1 && (!workers_ || workers_->size() != threads))
+        {
+            workers_ = std::make_unique<LevelWorkers>(threads);
+        }
+        while (!frontier_.empty())
+        {
+            next_.clear();
+            if (threads > 1 && frontier_.size() >= PARALLEL_MIN_FRONTIER)
+            {
+                expand_parallel(level + 1);
+                ++parallel_levels_;
+            }
+            else
+            {
+                expand_range<false>(0, frontier_.size(), level + 1, next_);
+            }
+            frontier_.swap(next_);
+            ++level;
+        }
+        build_directions();
+    }
+
+    // マスごとのコストを使って Dijkstra で距離を求める
+    // コストは 1〜254 の小さな整数なので、ヒープの代わりにバケットキュー（Dial 法）を使う
+    void build_dijkstra(const std::vector<std::uint32_t>& goals)
+    {
+        begin(goals);
+        for (auto& bucket : buckets_)
+        {
+            bucket.clear();
+        }
+        buckets_[0].swap(frontier_);
+
+        std::size_t pending = buckets_[0].size();
+        for (std::uint32_t d = 0; pending > 0; ++d)
+        {
+            auto& bucket = buckets_[d % BUCKET_COUNT];
+            // 処理中に同じバケットへ追加されることはない（コストは1以上）
+            for (std::size_t i = 0; i < bucket.size(); ++i)
+            {
+                const std::uint32_t cell = bucket[i];
+                --pending;
+                if (dist_[cell] != d || visited_.test(cell))
+                {
+                    continue; // もっと短い距離で確定済み
+                }
+                visited_.set(cell);
+
+                for_each_neighbor(cell, [&](std::uint32_t n)
+                    {
+                        const std::uint32_t nd = d + grid_.cost[n];
+                        if (nd < dist_[n])
+                        {
+                            dist_[n] = nd;
+                            buckets_[nd % BUCKET_COUNT].push_back(n);
+                            ++pending;
+                        }
+                    });
+            }
+            bucket.clear();
+        }
+        build_directions();
+    }
+
+    std::uint32_t distance(std::uint32_t cell) const { return dist_[cell]; }
+    Direction     direction(std::uint32_t cell) const { return static_cast<Direction>(dir_[cell]); }
+
+    // 直前の build_bfs で、フロンティアを分担して広げた段の数（確認用）
+    std::size_t parallel_levels() const { return parallel_levels_; }
+
+    // 敵を1マス進める（ゴールや行き止まりならその場にとどまる）
+    std::uint32_t step(std::uint32_t cell) const
+    {
+        const std::uint8_t d = dir_[cell];
+        if (d >= Goal)
+        {
+            return cell;
+        }
+        return cell + DY[d] * grid_.width + DX[d];
+    }
+
+private:
+    static constexpr std::size_t BUCKET_COUNT = 256; // 最大コスト + 1 以上あればよい
+    static constexpr std::size_t PARALLEL_MIN_FRONTIER = 4096;
+
+    // バッファは使い回すので、2回目以降の探索ではメモリ確保が起きない
+    void begin(const std::vector<std::uint32_t>& goals)
+    {
+        dist_.assign(grid_.size(), UNREACHABLE);
+        visited_.reset(grid_.size());
+        frontier_.clear();
+        frontier_.reserve(grid_.size());
+        next_.reserve(grid_.size());
+
+        // 複数のゴールを同時にスタート地点にする（マルチソース）
+        for (std::uint32_t g : goals)
+        {
+            if (grid_.cost[g] == WALL || dist_[g] == 0)
+            {
+                continue;
+            }
+            dist_[g] = 0;
+            frontier_.push_back(g);
+        }
+    }
+
+    template<typename Func>
+    void for_each_neighbor(std::uint32_t cell, Func&& func) const
+    {
+        const int x = static_cast<int>(cell % grid_.width);
+        const int y = static_cast<int>(cell / grid_.width);
+        for (int k = 0; k < 4; ++k)
+        {
+            const int nx = x + DX[k];
+            const int ny = y + DY[k];
+            if (nx < 0 || ny < 0 || nx >= grid_.width || ny >= grid_.height)
+            {
+                continue;
+            }
+            const std::uint32_t n = grid_.index(nx, ny);
+            if (grid_.cost[n] != WALL)
+            {
+                func(n);
+            }
+        }
+    }
+
+    // frontier_[begin, end) の隣を調べ、新しく届いたマスを out に積む。
+    // Shared = true は他のスレッドと同時に visited_ を書くとき（expand_parallel から）
+    template<bool Shared>
+    void expand_range(std::size_t begin, std::size_t end, std::uint32_t level,
+                      std::vector<std::uint32_t>& out)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            for_each_neighbor(frontier_[i], [&](std::uint32_t n)
+                {
+                    if (Shared ? visited_.claim(n) : visited_.try_set(n))
+                    {
+                        dist_[n] = level;
+                        out.push_back(n);
+                    }
+                });
+        }
+    }
+
+    void expand_parallel(std::uint32_t level)
+    {
+        const int threads = workers_->size();
+        local_next_.resize(threads);
+        const std::size_t chunk = (frontier_.size() + threads - 1) / threads;
+        // 同じマスを取り合ったときは claim() で勝った1スレッドだけが dist_ を書く
+        workers_->run([this, chunk, level](int t)
+            {
+                const std::size_t begin = std::min(frontier_.size(), chunk * t);
+                const std::size_t end = std::min(frontier_.size(), begin + chunk);
+                local_next_[t].clear();
+                expand_range<true>(begin, end, level, local_next_[t]);
+            });
+        for (const auto& local : local_next_)
+        {
+            next_.insert(next_.end(), local.begin(), local.end());
+        }
+    }
+
+    // 距離が一番小さい隣のマスへ向かう矢印を作る
+    void build_directions()
+    {
+        dir_.assign(grid_.size(), Blocked);
+        for (std::uint32_t cell = 0; cell < grid_.size(); ++cell)
+        {
+            if (dist_[cell] == UNREACHABLE)
+            {
+                continue;
+            }
+            if (dist_[cell] == 0)
+            {
+                dir_[cell] = Goal;
+                continue;
+            }
+            const int x = static_cast<int>(cell % grid_.width);
+            const int y = static_cast<int>(cell / grid_.width);
+            std::uint32_t best = dist_[cell];
+            for (int k = 0; k < 4; ++k)
+            {
+                const int nx = x + DX[k];
+                const int ny = y + DY[k];
+                if (nx < 0 || ny < 0 || nx >= grid_.width || ny >= grid_.height)
+                {
+                    continue;
+                }
+                const std::uint32_t n = grid_.index(nx, ny);
+                if (dist_[n] < best)
+                {
+                    best = dist_[n];
+                    dir_[cell] = static_cast<std::uint8_t>(k);
+                }
+            }
+        }
+    }
+
+    const Grid& grid_;
+    std::vector<std::uint32_t> dist_;
+    std::vector<std::uint8_t>  dir_;
+    Bitset                     visited_;
+    std::vector<std::uint32_t> frontier_;
+    std::vector<std::uint32_t> next_;
+    std::vector<std::vector<std::uint32_t>> local_next_;
+    std::unique_ptr<LevelWorkers> workers_; // build_bfs(threads > 1) で初めて作り、以後は使い回す
+    std::size_t parallel_levels_ = 0;
+    std::vector<std::vector<std::uint32_t>> buckets_ = std::vector<std::vector<std::uint32_t>>(BUCKET_COUNT);
+};
+
+Grid load_map(const std::vector<std::string>& rows)
+{
+    Grid grid(static_cast<int>(rows[0].size()), static_cast<int>(rows.size()));
+    for (int y = 0; y < grid.height; ++y)
+    {
+        for (int x = 0; x < grid.width; ++x)
+        {
+            const char c = rows[y][x];
+            grid.cost[grid.index(x, y)] = c == '#' ? WALL : c == '~' ? 5 : 1; // ~ は沼地
+        }
+    }
+    return grid;
+}
+
+void print_field(const Grid& grid, const FlowField& field)
+{
+    const char arrows[] = { '>', '<', 'v', '^', 'P', '#' };
+    for (int y = 0; y < grid.height; ++y)
+    {
+        for (int x = 0; x < grid.width; ++x)
+        {
+            std::cout << arrows[field.direction(grid.index(x, y))];
+        }
+        std::cout << "\n";
+    }
+}
+
+int main()
+{
+    const Grid map = load_map({
+        "....................",
+        ".######.....~~~~....",
+        "......#.....~~~~....",
+        "..E...#..######.....",
+        "......#.......#...E.",
+        "..........E...#.....",
+    });
+    const std::uint32_t player = map.index(8, 0);
+
+    FlowField field(map);
+
+    std::cout << "=== BFS フローフィールド ===" << std::endl;
+    field.build_bfs({ player });
+    print_field(map, field);
+
+    std::cout << "\n=== Dijkstra フローフィールド（沼地を避ける） ===" << std::endl;
+    field.build_dijkstra({ player });
+    print_field(map, field);
+
+    // 全ての敵が同じフローフィールドを共有して追いかける
+    std::vector<std::uint32_t> enemies = { map.index(2, 3), map.index(18, 4), map.index(10, 5) };
+    std::cout << "\n=== 敵の移動 ===" << std::endl;
+    for (std::size_t i = 0; i < enemies.size(); ++i)
+    {
+        std::uint32_t cell = enemies[i];
+        int steps = 0;
+        while (field.direction(cell) != Goal && field.direction(cell) != Blocked)
+        {
+            cell = field.step(cell);
+            ++steps;
+        }
+        std::cout << "敵" << i << ": " << steps << "歩でプレイヤーに到達 (コスト "
+                  << field.distance(enemies[i]) << ")" << std::endl;
+    }
+
+    // --- 大きなマップでの計測 ---
+    Grid large(2048, 2048);
+    for (int y = 0; y < large.height; y += 8)
+    {
+        for (int x = 0; x < large.width - 16; ++x)
+        {
+            large.cost[large.index((y / 8) % 2 ? x + 16 : x, y)] = WALL; // 蛇行する通路
+        }
+    }
+    FlowField large_field(large);
+    const std::vector<std::uint32_t> goals = { large.index(0, 1), large.index(2047, 2047) };
+    // 1コアの環境でも分担の経路を通るように、最低4スレッドで比べる
+    const int hw = static_cast<int>(std::max(4u, std::thread::hardware_concurrency()));
+
+    for (int threads : { 1, hw })
+    {
+        const auto start = std::chrono::steady_clock::now();
+        large_field.build_bfs(goals, threads);
+        const auto end = std::chrono::steady_clock::now();
+        std::cout << "\n2048x2048 蛇行マップ BFS (" << threads << "スレッド): "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms（分担した段: "
+                  << large_field.parallel_levels() << "）";
+    }
+    std::cout << std::endl;
+
+    // 壁のない広いマップでは、中央から広がるフロンティアが数千マスになり、分担する段が多くなる
+    Grid open(4096, 4096);
+    FlowField open_field(open);
+    const std::vector<std::uint32_t> center = { open.index(2048, 2048) };
+    std::vector<std::uint32_t> serial_dist(open.size());
+    std::vector<Direction> serial_dir(open.size());
+    for (int threads : { 1, hw })
+    {
+        const auto start = std::chrono::steady_clock::now();
+        open_field.build_bfs(center, threads);
+        const auto end = std::chrono::steady_clock::now();
+        bool same = true;
+        for (std::uint32_t cell = 0; cell < open.size(); ++cell)
+        {
+            if (threads == 1)
+            {
+                serial_dist[cell] = open_field.distance(cell);
+                serial_dir[cell] = open_field.direction(cell);
+            }
+            else
+            {
+                same = same && serial_dist[cell] == open_field.distance(cell) && serial_dir[cell] == open_field.direction(cell);
+            }
+        }
+        std::cout << "4096x4096 広いマップ BFS (" << threads << "スレッド): "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms（分担した段: "
+                  << open_field.parallel_levels() << "）";
+        if (threads > 1)
+        {
+            std::cout << " 1スレッドの結果と" << (same ? "一致" : "不一致!");
+        }
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
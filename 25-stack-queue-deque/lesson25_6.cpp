@@ -0,0 +1,595 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// --- 階層型経路探索（HPA*）と経路キャッシュ ---
+// 大きなマップを「クラスタ」（例: 16x16 マス）に区切り、
+// クラスタ同士の出入口（エントランス）だけを結んだ小さなグラフを事前に作っておく。
+// 長距離の経路はまずこの小さなグラフ上で探し、最後にクラスタ内の細かい道を BFS で埋める。
+// マスが変わったときは、そのマスを含むクラスタ（と境界を共有する隣）だけを作り直す
+
+constexpr std::uint32_t INF = std::numeric_limits<std::uint32_t>::max();
+
+constexpr int DX[4] = { 1, -1, 0, 0 };
+constexpr int DY[4] = { 0, 0, 1, -1 };
+
+struct Grid
+{
+    int width;
+    int height;
+    std::vector<bool> wall;
+
+    Grid(int w, int h) : width(w), height(h), wall(static_cast<std::size_t>(w) * h, false) {}
+
+    std::uint32_t index(int x, int y) const { return static_cast<std::uint32_t>(y * width + x); }
+    int  x_of(std::uint32_t cell) const { return static_cast<int>(cell % width); }
+    int  y_of(std::uint32_t cell) const { return static_cast<int>(cell / width); }
+    bool inside(int x, int y) const { return x >= 0 && y >= 0 && x < width && y < height; }
+    bool open(int x, int y) const { return inside(x, y) && !wall[index(x, y)]; }
+};
+
+// 矩形の範囲内だけで BFS する（クラスタ内の探索用）。バッファは使い回す
+class LocalBfs
+{
+public:
+    explicit LocalBfs(const Grid& grid) : grid_(grid) {}
+
+    void run(std::uint32_t source, int x0, int y0, int w, int h)
+    {
+        x0_ = x0;
+        y0_ = y0;
+        w_ = w;
+        h_ = h;
+        dist_.assign(static_cast<std::size_t>(w) * h, INF);
+        parent_.assign(static_cast<std::size_t>(w) * h, INF);
+        queue_.clear();
+
+        dist_[local(source)] = 0;
+        queue_.push_back(source);
+        for (std::size_t head = 0; head < queue_.size(); ++head)
+        {
+            const std::uint32_t cell = queue_[head];
+            const int x = grid_.x_of(cell);
+            const int y = grid_.y_of(cell);
+            for (int k = 0; k < 4; ++k)
+            {
+                const int nx = x + DX[k];
+                const int ny = y + DY[k];
+                if (nx < x0_ || ny < y0_ || nx >= x0_ + w_ || ny >= y0_ + h_ || !grid_.open(nx, ny))
+                {
+                    continue;
+                }
+                const std::uint32_t n = grid_.index(nx, ny);
+                if (dist_[local(n)] == INF)
+                {
+                    dist_[local(n)] = dist_[local(cell)] + 1;
+                    parent_[local(n)] = cell;
+                    queue_.push_back(n);
+                }
+            }
+        }
+    }
+
+    std::uint32_t dist(std::uint32_t cell) const { return dist_[local(cell)]; }
+
+    // source から cell までの道を out に追加する（source 自身は含めない）
+    void append_path(std::uint32_t cell, std::vector<std::uint32_t>& out) const
+    {
+        const std::size_t first = out.size();
+        for (std::uint32_t c = cell; parent_[local(c)] != INF; c = parent_[local(c)])
+        {
+            out.push_back(c);
+        }
+        std::reverse(out.begin() + static_cast<std::ptrdiff_t>(first), out.end());
+    }
+
+private:
+    std::size_t local(std::uint32_t cell) const
+    {
+        return static_cast<std::size_t>(grid_.y_of(cell) - y0_) * w_ + (grid_.x_of(cell) - x0_);
+    }
+
+    const Grid& grid_;
+    int x0_ = 0, y0_ = 0, w_ = 0, h_ = 0;
+    std::vector<std::uint32_t> dist_;
+    std::vector<std::uint32_t> parent_;
+    std::vector<std::uint32_t> queue_;
+};
+
+class HierarchicalPathfinder
+{
+public:
+    HierarchicalPathfinder(Grid& grid, int cluster_size)
+        : grid_(grid)
+        , size_(cluster_size)
+        , cols_((grid.width + cluster_size - 1) / cluster_size)
+        , rows_((grid.height + cluster_size - 1) / cluster_size)
+        , clusters_(static_cast<std::size_t>(cols_) * rows_)
+        , bfs_(grid)
+    {
+        for (int c = 0; c < static_cast<int>(clusters_.size()); ++c)
+        {
+            rebuild_cluster(c);
+        }
+    }
+
+    // マスを書き換え、影響するクラスタだけを作り直す。作り直したクラスタ数を返す
+    int set_wall(int x, int y, bool is_wall)
+    {
+        grid_.wall[grid_.index(x, y)] = is_wall;
+
+        std::vector<int> dirty = { cluster_of(x, y) };
+        // 境界上のマスなら、隣のクラスタのエントランスも変わる
+        for (int k = 0; k < 4; ++k)
+        {
+            const int nx = x + DX[k];
+            const int ny = y + DY[k];
+            if (grid_.inside(nx, ny) && cluster_of(nx, ny) != dirty[0])
+            {
+                dirty.push_back(cluster_of(nx, ny));
+            }
+        }
+        for (int c : dirty)
+        {
+            rebuild_cluster(c);
+        }
+        return static_cast<int>(dirty.size());
+    }
+
+    // start から goal までのマス列を返す（見つからなければ空）
+    std::vector<std::uint32_t> find_path(std::uint32_t start, std::uint32_t goal)
+    {
+        std::vector<std::uint32_t> path;
+        const int sc = cluster_of(start);
+        const int gc = cluster_of(goal);
+
+        // 同じクラスタ内なら、まずクラスタ内だけで探す
+        if (sc == gc)
+        {
+            run_bfs_in(sc, start);
+            if (bfs_.dist(goal) != INF)
+            {
+                path.push_back(start);
+                bfs_.append_path(goal, path);
+                return path;
+            }
+        }
+
+        const std::vector<std::uint32_t>* abstract = cached_abstract_path(start, goal);
+        if (abstract == nullptr)
+        {
+            ++stats_.cache_misses;
+            std::vector<std::uint32_t> nodes = search_abstract(start, goal);
+            if (nodes.empty())
+            {
+                return path;
+            }
+            abstract = &store_abstract_path(start, goal, std::move(nodes));
+        }
+        else
+        {
+            ++stats_.cache_hits;
+        }
+
+        // 抽象経路の各区間を実際のマス列に展開する
+        path.push_back(start);
+        for (std::size_t i = 1; i < abstract->size(); ++i)
+        {
+            const std::uint32_t from = (*abstract)[i - 1];
+            const std::uint32_t to = (*abstract)[i];
+            const int from_cluster = cluster_of(from);
+            if (from_cluster != cluster_of(to))
+            {
+                path.push_back(to); // 境界をまたぐ1歩
+                continue;
+            }
+            run_bfs_in(from_cluster, from);
+            bfs_.append_path(to, path);
+        }
+        return path;
+    }
+
+    struct Stats
+    {
+        int cache_hits = 0;
+        int cache_misses = 0;
+        int abstract_expanded = 0;
+    };
+
+    const Stats& stats() const { return stats_; }
+
+    std::size_t abstract_node_count() const
+    {
+        std::size_t n = 0;
+        for (const auto& c : clusters_)
+        {
+            n += c.nodes.size();
+        }
+        return n;
+    }
+
+private:
+    struct Edge
+    {
+        std::uint32_t to;   // 行き先のマス
+        std::uint32_t cost;
+    };
+
+    // エントランスのマス。同じクラスタ内の他のエントランスと、隣のクラスタへの辺を持つ
+    struct Node
+    {
+        std::uint32_t     cell;
+        std::vector<Edge> edges;
+    };
+
+    struct Cluster
+    {
+        std::vector<Node> nodes;
+        std::uint32_t     version = 0; // 作り直すたびに増やす（キャッシュの無効化に使う）
+    };
+
+    // キャッシュした抽象経路と、通過したクラスタのバージョン
+    struct CachedPath
+    {
+        std::vector<std::uint32_t>               nodes;
+        std::vector<std::pair<int, std::uint32_t>> cluster_versions;
+    };
+
+    int cluster_of(int x, int y) const { return (y / size_) * cols_ + x / size_; }
+    int cluster_of(std::uint32_t cell) const { return cluster_of(grid_.x_of(cell), grid_.y_of(cell)); }
+
+    void run_bfs_in(int c, std::uint32_t source)
+    {
+        const int x0 = (c % cols_) * size_;
+        const int y0 = (c / cols_) * size_;
+        bfs_.run(source, x0, y0, std::min(size_, grid_.width - x0), std::min(size_, grid_.height - y0));
+    }
+
+    // クラスタ c の辺 k（DX/DY の向き）に沿って、両側が通れるマスの連続区間を探し、
+    // 区間ごとにエントランスを置く。長い区間は両端に2つ置く
+    void collect_border(int c, int k, std::vector<Node>& nodes) const
+    {
+        const int x0 = (c % cols_) * size_;
+        const int y0 = (c / cols_) * size_;
+        const int w = std::min(size_, grid_.width - x0);
+        const int h = std::min(size_, grid_.height - y0);
+        const bool vertical = DX[k] != 0; // 左右の辺はマスが縦に並ぶ
+        const int length = vertical ? h : w;
+
+        auto cell_at = [&](int i)
+            {
+                const int x = vertical ? (DX[k] > 0 ? x0 + w - 1 : x0) : x0 + i;
+                const int y = vertical ? y0 + i : (DY[k] > 0 ? y0 + h - 1 : y0);
+                return std::pair{ x, y };
+            };
+        auto passable = [&](int i)
+            {
+                const auto [x, y] = cell_at(i);
+                return grid_.open(x, y) && grid_.open(x + DX[k], y + DY[k]);
+            };
+        auto add = [&](int i)
+            {
+                const auto [x, y] = cell_at(i);
+                const std::uint32_t cell = grid_.index(x, y);
+                const Edge inter = { grid_.index(x + DX[k], y + DY[k]), 1 };
+                for (auto& n : nodes)
+                {
+                    if (n.cell == cell) // クラスタの角は2つの辺のエントランスになりうる
+                    {
+                        n.edges.push_back(inter);
+                        return;
+                    }
+                }
+                nodes.push_back({ cell, { inter } });
+            };
+
+        constexpr int LONG_RUN = 6;
+        for (int i = 0; i < length;)
+        {
+            if (!passable(i))
+            {
+                ++i;
+                continue;
+            }
+            int end = i;
+            while (end < length && passable(end))
+            {
+                ++end;
+            }
+            if (end - i >= LONG_RUN)
+            {
+                add(i);
+                add(end - 1);
+            }
+            else
+            {
+                add((i + end - 1) / 2);
+            }
+            i = end;
+        }
+    }
+
+    void rebuild_cluster(int c)
+    {
+        Cluster& cluster = clusters_[c];
+        cluster.nodes.clear();
+        for (int k = 0; k < 4; ++k)
+        {
+            collect_border(c, k, cluster.nodes);
+        }
+
+        // クラスタ内でエントランス同士の距離を前計算する
+        for (auto& node : cluster.nodes)
+        {
+            run_bfs_in(c, node.cell);
+            for (const auto& other : cluster.nodes)
+            {
+                const std::uint32_t d = bfs_.dist(other.cell);
+                if (other.cell != node.cell && d != INF)
+                {
+                    node.edges.push_back({ other.cell, d });
+                }
+            }
+        }
+        ++cluster.version;
+    }
+
+    const Node* find_node(std::uint32_t cell) const
+    {
+        for (const auto& n : clusters_[cluster_of(cell)].nodes)
+        {
+            if (n.cell == cell)
+            {
+                return &n;
+            }
+        }
+        return nullptr;
+    }
+
+    std::uint32_t heuristic(std::uint32_t a, std::uint32_t b) const
+    {
+        return static_cast<std::uint32_t>(std::abs(grid_.x_of(a) - grid_.x_of(b))
+                                        + std::abs(grid_.y_of(a) - grid_.y_of(b)));
+    }
+
+    // 抽象グラフ上の A*。start と goal は一時的なノードとして、
+    // 各自のクラスタ内のエントランスへの辺だけを BFS で求める
+    std::vector<std::uint32_t> search_abstract(std::uint32_t start, std::uint32_t goal)
+    {
+        std::vector<Edge> start_edges;
+        run_bfs_in(cluster_of(start), start);
+        for (const auto& n : clusters_[cluster_of(start)].nodes)
+        {
+            if (bfs_.dist(n.cell) != INF)
+            {
+                start_edges.push_back({ n.cell, bfs_.dist(n.cell) });
+            }
+        }
+        std::unordered_map<std::uint32_t, std::uint32_t> to_goal; // エントランス → goal の距離
+        run_bfs_in(cluster_of(goal), goal);
+        for (const auto& n : clusters_[cluster_of(goal)].nodes)
+        {
+            if (bfs_.dist(n.cell) != INF)
+            {
+                to_goal[n.cell] = bfs_.dist(n.cell);
+            }
+        }
+
+        using Entry = std::pair<std::uint32_t, std::uint32_t>; // (f, cell)
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+        std::unordered_map<std::uint32_t, std::uint32_t> g;
+        std::unordered_map<std::uint32_t, std::uint32_t> parent;
+
+        g[start] = 0;
+        open.push({ heuristic(start, goal), start });
+        while (!open.empty())
+        {
+            const auto [f, cell] = open.top();
+            open.pop();
+            const std::uint32_t gc = g[cell];
+            if (f != gc + heuristic(cell, goal))
+            {
+                continue; // 古いエントリ
+            }
+            if (cell == goal)
+            {
+                std::vector<std::uint32_t> nodes = { goal };
+                for (std::uint32_t c = goal; c != start; c = parent[c])
+                {
+                    nodes.push_back(parent[c]);
+                }
+                std::reverse(nodes.begin(), nodes.end());
+                return nodes;
+            }
+            ++stats_.abstract_expanded;
+
+            auto relax = [&](std::uint32_t to, std::uint32_t cost)
+                {
+                    const std::uint32_t ng = gc + cost;
+                    auto it = g.find(to);
+                    if (it == g.end() || ng < it->second)
+                    {
+                        g[to] = ng;
+                        parent[to] = cell;
+                        open.push({ ng + heuristic(to, goal), to });
+                    }
+                };
+
+            if (cell == start)
+            {
+                for (const auto& e : start_edges)
+                {
+                    relax(e.to, e.cost);
+                }
+            }
+            if (const Node* node = find_node(cell))
+            {
+                for (const auto& e : node->edges)
+                {
+                    relax(e.to, e.cost);
+                }
+            }
+            if (auto it = to_goal.find(cell); it != to_goal.end())
+            {
+                relax(goal, it->second);
+            }
+        }
+        return {};
+    }
+
+    static std::uint64_t key(std::uint32_t start, std::uint32_t goal)
+    {
+        return (static_cast<std::uint64_t>(start) << 32) | goal;
+    }
+
+    // 通過したクラスタがどれも作り直されていなければ、キャッシュした経路をそのまま使える
+    // （他のクラスタの変更で近道ができても、キャッシュした経路は通れるので使い続ける）
+    const std::vector<std::uint32_t>* cached_abstract_path(std::uint32_t start, std::uint32_t goal) const
+    {
+        auto it = cache_.find(key(start, goal));
+        if (it == cache_.end())
+        {
+            return nullptr;
+        }
+        for (const auto& [c, version] : it->second.cluster_versions)
+        {
+            if (clusters_[c].version != version)
+            {
+                return nullptr;
+            }
+        }
+        return &it->second.nodes;
+    }
+
+    const std::vector<std::uint32_t>& store_abstract_path(std::uint32_t start, std::uint32_t goal,
+                                                          std::vector<std::uint32_t> nodes)
+    {
+        CachedPath& entry = cache_[key(start, goal)];
+        entry.cluster_versions.clear();
+        for (std::uint32_t cell : nodes)
+        {
+            const int c = cluster_of(cell);
+            if (entry.cluster_versions.empty() || entry.cluster_versions.back().first != c)
+            {
+                entry.cluster_versions.push_back({ c, clusters_[c].version });
+            }
+        }
+        entry.nodes = std::move(nodes);
+        return entry.nodes;
+    }
+
+    Grid&  grid_;
+    int    size_;
+    int    cols_;
+    int    rows_;
+    std::vector<Cluster> clusters_;
+    LocalBfs bfs_;
+    std::unordered_map<std::uint64_t, CachedPath> cache_;
+    Stats  stats_;
+};
+
+// 比較用：マップ全体を対象にした普通の A*
+std::size_t flat_astar_length(const Grid& grid, std::uint32_t start, std::uint32_t goal)
+{
+    std::vector<std::uint32_t> g(grid.wall.size(), INF);
+    using Entry = std::pair<std::uint32_t, std::uint32_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    auto h = [&](std::uint32_t c)
+        {
+            return static_cast<std::uint32_t>(std::abs(grid.x_of(c) - grid.x_of(goal))
+                                            + std::abs(grid.y_of(c) - grid.y_of(goal)));
+        };
+    g[start] = 0;
+    open.push({ h(start), start });
+    while (!open.empty())
+    {
+        const auto [f, cell] = open.top();
+        open.pop();
+        if (cell == goal)
+        {
+            return g[goal] + 1;
+        }
+        if (f != g[cell] + h(cell))
+        {
+            continue;
+        }
+        for (int k = 0; k < 4; ++k)
+        {
+            const int nx = grid.x_of(cell) + DX[k];
+            const int ny = grid.y_of(cell) + DY[k];
+            if (grid.open(nx, ny) && g[cell] + 1 < g[grid.index(nx, ny)])
+            {
+                g[grid.index(nx, ny)] = g[cell] + 1;
+                open.push({ g[cell] + 1 + h(grid.index(nx, ny)), grid.index(nx, ny) });
+            }
+        }
+    }
+    return 0;
+}
+
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+    auto us_since = [](Clock::time_point t)
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - t).count();
+        };
+
+    // 1024x1024 のマップに障害物をばらまく
+    Grid grid(1024, 1024);
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> pos(0, 1023);
+    for (int i = 0; i < 20000; ++i)
+    {
+        const int x = pos(rng);
+        const int y = pos(rng);
+        for (int j = 0; j < 12; ++j)
+        {
+            grid.wall[grid.index(std::min(x + j, 1023), y)] = true; // 横長の壁
+        }
+    }
+    const std::uint32_t start = grid.index(1, 1);
+    const std::uint32_t goal = grid.index(1020, 1000);
+    grid.wall[start] = false;
+    grid.wall[goal] = false;
+
+    auto t = Clock::now();
+    HierarchicalPathfinder hpa(grid, 16);
+    std::cout << "前計算: " << us_since(t) << "us (エントランス " << hpa.abstract_node_count() << "個)" << std::endl;
+
+    t = Clock::now();
+    const std::size_t flat_len = flat_astar_length(grid, start, goal);
+    std::cout << "通常の A*:       " << us_since(t) << "us 長さ " << flat_len << std::endl;
+
+    t = Clock::now();
+    auto path = hpa.find_path(start, goal);
+    std::cout << "HPA* (初回):     " << us_since(t) << "us 長さ " << path.size() << std::endl;
+
+    t = Clock::now();
+    path = hpa.find_path(start, goal);
+    std::cout << "HPA* (キャッシュ): " << us_since(t) << "us 長さ " << path.size() << std::endl;
+
+    // 経路の途中に壁を置くと、そのクラスタだけ作り直され、キャッシュは自動で無効になる
+    const std::uint32_t blocked = path[path.size() / 2];
+    t = Clock::now();
+    const int rebuilt = hpa.set_wall(grid.x_of(blocked), grid.y_of(blocked), true);
+    std::cout << "\nマス変更: " << rebuilt << "クラスタを作り直し (" << us_since(t) << "us)" << std::endl;
+
+    t = Clock::now();
+    path = hpa.find_path(start, goal);
+    std::cout << "HPA* (再探索):   " << us_since(t) << "us 長さ " << path.size() << std::endl;
+
+    const auto& s = hpa.stats();
+    std::cout << "キャッシュ ヒット " << s.cache_hits << " / ミス " << s.cache_misses
+              << " / 展開した抽象ノード " << s.abstract_expanded << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,480 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <queue>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// --- スレッド間タスク受け渡し用のロックフリーキュー ---
+// std::queue<Task> は複数スレッドから同時に push すると壊れる。
+// ネットワーク・AI・I/O スレッドからシミュレーションスレッドへ仕事を渡すため、
+//   - MpscQueue : 複数プロデューサ / 単一コンシューマ（固定容量、ロックフリー）
+//   - SpscRing  : 単一プロデューサ / 単一コンシューマ（さらに軽いリングバッファ）
+// を作る。どちらも空のときはスリープして待てる（Linux では std::atomic::wait が futex になる）
+
+struct Task
+{
+    std::string name;
+    int         priority;
+};
+
+// 別スレッドが書く変数は別のキャッシュラインに置く（false sharing 防止）
+constexpr std::size_t CACHE_LINE = 64;
+
+template<typename T>
+struct alignas(CACHE_LINE) Padded
+{
+    T value{};
+};
+
+// コンシューマの「寝る / 起こす」を管理する
+// プロデューサは相手が寝ているときだけ notify するので、普段はシステムコールが起きない
+class WakeSignal
+{
+public:
+    // コンシューマ側：try_again() が失敗したら眠る
+    template<typename Func>
+    void sleep_unless(Func&& try_again)
+    {
+        const std::uint32_t seen = epoch_.value.load(std::memory_order_acquire);
+        sleeping_.value.store(true, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!try_again())
+        {
+            epoch_.value.wait(seen, std::memory_order_acquire);
+        }
+        sleeping_.value.store(false, std::memory_order_relaxed);
+    }
+
+    // プロデューサ側：データを公開した後に呼ぶ
+    void notify()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping_.value.load(std::memory_order_relaxed))
+        {
+            epoch_.value.fetch_add(1, std::memory_order_release);
+            epoch_.value.notify_one();
+        }
+    }
+
+    // 終了時などに、寝ているかどうかに関係なく起こす
+    void wake()
+    {
+        epoch_.value.fetch_add(1, std::memory_order_release);
+        epoch_.value.notify_one();
+    }
+
+private:
+    Padded<std::atomic<std::uint32_t>> epoch_;
+    Padded<std::atomic<bool>>          sleeping_;
+};
+
+// 複数プロデューサ / 単一コンシューマの固定容量キュー
+// 各セルが持つ通し番号（sequence）で「書き込み済みか」「空いているか」を判定する
+template<typename T, std::size_t Capacity>
+class MpscQueue
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity は2のべき乗にする");
+
+public:
+    MpscQueue()
+    {
+        for (std::size_t i = 0; i < Capacity; ++i)
+        {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MpscQueue()
+    {
+        T discard;
+        while (try_pop(discard))
+        {
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // 満杯なら false を返す（ブロックしない）。失敗したとき value はそのまま残る
+    bool try_push(T&& value)
+    {
+        std::size_t pos = tail_.value.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;)
+        {
+            cell = &cells_[pos & MASK];
+            const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0)
+            {
+                // このセルは空いている。tail を進められたプロデューサが書き込み権を得る
+                if (tail_.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false; // 1周前のデータがまだ読まれていない = 満杯
+            }
+            else
+            {
+                pos = tail_.value.load(std::memory_order_relaxed);
+            }
+        }
+
+        ::new (cell->storage) T(std::move(value));
+        cell->sequence.store(pos + 1, std::memory_order_release); // コンシューマに公開
+        signal_.notify();
+        return true;
+    }
+
+    // コンシューマ専用
+    bool try_pop(T& out)
+    {
+        Cell& cell = cells_[head_ & MASK];
+        if (cell.sequence.load(std::memory_order_acquire) != head_ + 1)
+        {
+            return false;
+        }
+        take(cell, out);
+        ++head_;
+        return true;
+    }
+
+    // まとめて最大 max_count 個取り出す。取り出した個数を返す
+    template<typename OutputIt>
+    std::size_t try_pop_batch(OutputIt out, std::size_t max_count)
+    {
+        std::size_t n = 0;
+        while (n < max_count)
+        {
+            Cell& cell = cells_[head_ & MASK];
+            if (cell.sequence.load(std::memory_order_acquire) != head_ + 1)
+            {
+                break;
+            }
+            T value;
+            take(cell, value);
+            *out++ = std::move(value);
+            ++head_;
+            ++n;
+        }
+        return n;
+    }
+
+    // 1個以上取り出せるまで眠って待つ。close() 後に空なら 0 を返す
+    template<typename OutputIt>
+    std::size_t wait_pop_batch(OutputIt out, std::size_t max_count)
+    {
+        for (;;)
+        {
+            if (std::size_t n = try_pop_batch(out, max_count))
+            {
+                return n;
+            }
+            if (closed_.value.load(std::memory_order_acquire))
+            {
+                return try_pop_batch(out, max_count); // close 直前に入ったもの
+            }
+            signal_.sleep_unless([this]()
+                {
+                    return ready() || closed_.value.load(std::memory_order_acquire);
+                });
+        }
+    }
+
+    void close()
+    {
+        closed_.value.store(true, std::memory_order_release);
+        signal_.wake();
+    }
+
+private:
+    static constexpr std::size_t MASK = Capacity - 1;
+
+    struct alignas(CACHE_LINE) Cell
+    {
+        std::atomic<std::size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    bool ready() const
+    {
+        return cells_[head_ & MASK].sequence.load(std::memory_order_acquire) == head_ + 1;
+    }
+
+    void take(Cell& cell, T& out)
+    {
+        T* value = std::launder(reinterpret_cast<T*>(cell.storage));
+        out = std::move(*value);
+        value->~T();
+        // 次の周回（head + Capacity）のプロデューサが使えるようにする
+        cell.sequence.store(head_ + Capacity, std::memory_order_release);
+    }
+
+    Padded<std::atomic<std::size_t>> tail_;   // プロデューサが奪い合う
+    alignas(CACHE_LINE) std::size_t  head_ = 0; // コンシューマだけが触る
+    Padded<std::atomic<bool>>        closed_;
+    WakeSignal                       signal_;
+    std::unique_ptr<Cell[]>          cells_ = std::make_unique<Cell[]>(Capacity);
+};
+
+// 単一プロデューサ / 単一コンシューマのリングバッファ
+// 相手側のインデックスを手元にキャッシュし、共有変数を読む回数を減らす
+template<typename T, std::size_t Capacity>
+class SpscRing
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity は2のべき乗にする");
+    static_assert(std::is_default_constructible_v<T>);
+
+public:
+    bool try_push(T&& value)
+    {
+        const std::size_t tail = tail_.value.load(std::memory_order_relaxed);
+        if (tail - cached_head_ == Capacity)
+        {
+            cached_head_ = head_.value.load(std::memory_order_acquire);
+            if (tail - cached_head_ == Capacity)
+            {
+                return false;
+            }
+        }
+        slots_[tail & MASK] = std::move(value);
+        tail_.value.store(tail + 1, std::memory_order_release);
+        signal_.notify();
+        return true;
+    }
+
+    template<typename OutputIt>
+    std::size_t try_pop_batch(OutputIt out, std::size_t max_count)
+    {
+        const std::size_t head = head_.value.load(std::memory_order_relaxed);
+        if (cached_tail_ == head)
+        {
+            cached_tail_ = tail_.value.load(std::memory_order_acquire);
+        }
+        std::size_t n = cached_tail_ - head;
+        n = n < max_count ? n : max_count;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            *out++ = std::move(slots_[(head + i) & MASK]);
+        }
+        head_.value.store(head + n, std::memory_order_release); // まとめて1回だけ公開
+        return n;
+    }
+
+    template<typename OutputIt>
+    std::size_t wait_pop_batch(OutputIt out, std::size_t max_count)
+    {
+        for (;;)
+        {
+            if (std::size_t n = try_pop_batch(out, max_count))
+            {
+                return n;
+            }
+            if (closed_.value.load(std::memory_order_acquire))
+            {
+                return try_pop_batch(out, max_count);
+            }
+            signal_.sleep_unless([this]()
+                {
+                    return tail_.value.load(std::memory_order_acquire) != head_.value.load(std::memory_order_relaxed)
+                        || closed_.value.load(std::memory_order_acquire);
+                });
+        }
+    }
+
+    void close()
+    {
+        closed_.value.store(true, std::memory_order_release);
+        signal_.wake();
+    }
+
+private:
+    static constexpr std::size_t MASK = Capacity - 1;
+
+    Padded<std::atomic<std::size_t>> head_;
+    alignas(CACHE_LINE) std::size_t  cached_tail_ = 0; // コンシューマ用
+    Padded<std::atomic<std::size_t>> tail_;
+    alignas(CACHE_LINE) std::size_t  cached_head_ = 0; // プロデューサ用
+    Padded<std::atomic<bool>>        closed_;
+    WakeSignal                       signal_;
+    std::unique_ptr<T[]>             slots_ = std::make_unique<T[]>(Capacity);
+};
+
+// 比較用：mutex で守った std::queue
+template<typename T>
+class LockedQueue
+{
+public:
+    void push(T value)
+    {
+        std::lock_guard lock(mutex_);
+        queue_.push(std::move(value));
+    }
+
+    bool try_pop(T& out)
+    {
+        std::lock_guard lock(mutex_);
+        if (queue_.empty())
+        {
+            return false;
+        }
+        out = std::move(queue_.front());
+        queue_.pop();
+        return true;
+    }
+
+private:
+    std::mutex    mutex_;
+    std::queue<T> queue_;
+};
+
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    // --- 複数スレッドからシミュレーションスレッドへタスクを送る ---
+    MpscQueue<Task, 1024> inbox;
+    constexpr int TASKS_PER_PRODUCER = 100000;
+    const char* sources[] = { "ネットワーク", "AI", "I/O" };
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < 3; ++p)
+    {
+        producers.emplace_back([&inbox, p, &sources]()
+            {
+                for (int i = 0; i < TASKS_PER_PRODUCER; ++i)
+                {
+                    Task task{ sources[p], i };
+                    while (!inbox.try_push(std::move(task)))
+                    {
+                        std::this_thread::yield(); // 満杯ならコンシューマに譲る
+                    }
+                }
+            });
+    }
+
+    std::thread closer([&producers, &inbox]()
+        {
+            for (auto& t : producers)
+            {
+                t.join();
+            }
+            inbox.close();
+        });
+
+    // シミュレーションスレッド：まとめて取り出して処理する
+    std::vector<Task> batch;
+    batch.reserve(256);
+    int received[3] = {};
+    int batches = 0;
+    for (;;)
+    {
+        batch.clear();
+        if (inbox.wait_pop_batch(std::back_inserter(batch), 256) == 0)
+        {
+            break; // close 済みで空
+        }
+        ++batches;
+        for (const Task& task : batch)
+        {
+            for (int p = 0; p < 3; ++p)
+            {
+                if (task.name == sources[p])
+                {
+                    ++received[p];
+                }
+            }
+        }
+    }
+    closer.join();
+
+    std::cout << "=== MPSC キュー ===" << std::endl;
+    for (int p = 0; p < 3; ++p)
+    {
+        std::cout << sources[p] << ": " << received[p] << "件" << std::endl;
+    }
+    std::cout << "バッチ取り出し回数: " << batches << std::endl;
+
+    // --- SPSC リングと mutex 版の速度比較 ---
+    // プロデューサとコンシューマが別コアで同時に動く環境で差が出る（1コアでは切り替えのコストが目立つ）
+    constexpr int N = 2'000'000;
+    {
+        SpscRing<int, 4096> ring;
+        const auto start = Clock::now();
+        std::thread producer([&ring]()
+            {
+                for (int i = 0; i < N; ++i)
+                {
+                    int value = i;
+                    while (!ring.try_push(std::move(value)))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+                ring.close();
+            });
+        long long sum = 0;
+        int buf[256];
+        while (std::size_t n = ring.wait_pop_batch(buf, 256))
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                sum += buf[i];
+            }
+        }
+        producer.join();
+        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+        std::cout << "\nSPSC リング:     " << ms << "ms (合計 " << sum << ")" << std::endl;
+    }
+    {
+        LockedQueue<int> queue;
+        std::atomic<bool> done = false;
+        const auto start = Clock::now();
+        std::thread producer([&queue, &done]()
+            {
+                for (int i = 0; i < N; ++i)
+                {
+                    queue.push(i);
+                }
+                done = true;
+            });
+        long long sum = 0;
+        int value;
+        for (;;)
+        {
+            if (queue.try_pop(value))
+            {
+                sum += value;
+            }
+            else if (done)
+            {
+                while (queue.try_pop(value))
+                {
+                    sum += value;
+                }
+                break;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+        std::cout << "mutex + queue:  " << ms << "ms (合計 " << sum << ")" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,561 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// --- インライン領域を持つ固定容量のリング deque ---
+// lesson25_3 の party は数人しか入らないのに、std::deque はブロック単位でヒープを確保する。
+// RingDeque<T, N> は N 個分の領域をオブジェクトの中に持ち、両端の追加・削除を O(1) で行う。
+// Growable = true にすると、N を超えたときだけヒープへ移って伸びる
+
+// 簡易的なヒープ確保回数のカウンタ（比較用）
+static std::size_t g_allocations = 0;
+
+void* operator new(std::size_t size)
+{
+    ++g_allocations;
+    if (void* p = std::malloc(size))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+// 置き換えた new/delete の中の malloc/free が同じ関数にインライン展開されると、
+// GCC 12 が「new と free の組み合わせ違い」と誤って警告するので、ここだけ止める
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+#pragma GCC diagnostic pop
+
+// N が収まる一番小さい符号なし整数型（小さな deque を小さく保つ）
+template<std::size_t N>
+using SmallIndex = std::conditional_t<N <= 0xFF, std::uint8_t,
+                   std::conditional_t<N <= 0xFFFF, std::uint16_t, std::uint32_t>>;
+
+template<typename T, std::size_t N, bool Growable = false>
+class RingDeque
+{
+    static_assert(N > 0, "N は1以上にする");
+
+public:
+    using value_type = T;
+    using size_type  = std::conditional_t<Growable, std::uint32_t, SmallIndex<N>>;
+
+    template<bool Const>
+    class Iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = std::conditional_t<Const, const T*, T*>;
+        using reference         = std::conditional_t<Const, const T&, T&>;
+        using owner_type        = std::conditional_t<Const, const RingDeque, RingDeque>;
+
+        Iterator() = default;
+        Iterator(owner_type* owner, difference_type index) : owner_(owner), index_(index) {}
+        operator Iterator<true>() const { return { owner_, index_ }; }
+
+        reference operator*() const { return (*owner_)[static_cast<std::size_t>(index_)]; }
+        pointer   operator->() const { return &**this; }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        Iterator& operator++() { ++index_; return *this; }
+        Iterator& operator--() { --index_; return *this; }
+        Iterator  operator++(int) { Iterator t = *this; ++index_; return t; }
+        Iterator  operator--(int) { Iterator t = *this; --index_; return t; }
+        Iterator& operator+=(difference_type n) { index_ += n; return *this; }
+        Iterator& operator-=(difference_type n) { index_ -= n; return *this; }
+
+        friend Iterator operator+(Iterator it, difference_type n) { return it += n; }
+        friend Iterator operator+(difference_type n, Iterator it) { return it += n; }
+        friend Iterator operator-(Iterator it, difference_type n) { return it -= n; }
+        friend difference_type operator-(const Iterator& a, const Iterator& b) { return a.index_ - b.index_; }
+        friend bool operator==(const Iterator& a, const Iterator& b) { return a.index_ == b.index_; }
+        friend auto operator<=>(const Iterator& a, const Iterator& b) { return a.index_ <=> b.index_; }
+
+    private:
+        owner_type*     owner_ = nullptr;
+        difference_type index_ = 0;
+    };
+
+    using iterator       = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    RingDeque() = default;
+
+    RingDeque(std::initializer_list<T> init)
+    {
+        for (const T& value : init)
+        {
+            push_back(value);
+        }
+    }
+
+    RingDeque(const RingDeque& other)
+    {
+        reserve(other.size_);
+        for (const T& value : other)
+        {
+            push_back(value);
+        }
+    }
+
+    RingDeque(RingDeque&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        take_from(std::move(other));
+    }
+
+    RingDeque& operator=(const RingDeque& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            reserve(other.size_);
+            for (const T& value : other)
+            {
+                push_back(value);
+            }
+        }
+        return *this;
+    }
+
+    RingDeque& operator=(RingDeque&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        if (this != &other)
+        {
+            clear();
+            take_from(std::move(other));
+        }
+        return *this;
+    }
+
+    ~RingDeque()
+    {
+        clear();
+        release_heap();
+    }
+
+    // --- 容量 ---
+    bool        empty() const { return size_ == 0; }
+    std::size_t size() const { return size_; }
+    std::size_t capacity() const
+    {
+        if constexpr (Growable)
+        {
+            return heap_.data != nullptr ? heap_.capacity : N;
+        }
+        return N;
+    }
+    bool is_inline() const
+    {
+        if constexpr (Growable)
+        {
+            return heap_.data == nullptr;
+        }
+        return true;
+    }
+
+    void reserve(std::size_t n)
+    {
+        if (n > capacity())
+        {
+            if constexpr (Growable)
+            {
+                relocate(n);
+            }
+            else
+            {
+                throw std::length_error("RingDeque の容量を超えます");
+            }
+        }
+    }
+
+    // --- 要素アクセス（先頭からの位置で指定する） ---
+    T&       operator[](std::size_t i) { return slot(physical(i)); }
+    const T& operator[](std::size_t i) const { return const_cast<RingDeque&>(*this)[i]; }
+
+    T& at(std::size_t i)
+    {
+        if (i >= size_)
+        {
+            throw std::out_of_range("RingDeque::at: 範囲外です");
+        }
+        return (*this)[i];
+    }
+
+    T&       front() { return (*this)[0]; }
+    const T& front() const { return (*this)[0]; }
+    T&       back() { return (*this)[size_ - 1]; }
+    const T& back() const { return (*this)[size_ - 1]; }
+
+    iterator       begin() { return { this, 0 }; }
+    iterator       end() { return { this, static_cast<std::ptrdiff_t>(size_) }; }
+    const_iterator begin() const { return { this, 0 }; }
+    const_iterator end() const { return { this, static_cast<std::ptrdiff_t>(size_) }; }
+
+    // --- 両端の追加・削除（すべて O(1)） ---
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+    void push_front(const T& value) { emplace_front(value); }
+    void push_front(T&& value) { emplace_front(std::move(value)); }
+
+    // args が自分の要素を指していてもよい（d.push_back(d.front()) など）。
+    // 満杯なら、新しい要素を先に新しい領域へ作ってから、古い要素を移す
+    template<typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        if (size_ == capacity())
+        {
+            return grow_emplace(size_, std::forward<Args>(args)...);
+        }
+        T* p = ::new (raw(physical(size_))) T(std::forward<Args>(args)...);
+        ++size_;
+        return *p;
+    }
+
+    template<typename... Args>
+    T& emplace_front(Args&&... args)
+    {
+        if (size_ == capacity())
+        {
+            return grow_emplace(0, std::forward<Args>(args)...);
+        }
+        const std::size_t cap = capacity();
+        const std::size_t new_head = head_ == 0 ? cap - 1 : head_ - 1;
+        T* p = ::new (raw(new_head)) T(std::forward<Args>(args)...);
+        head_ = static_cast<size_type>(new_head);
+        ++size_;
+        return *p;
+    }
+
+    void pop_back()
+    {
+        check_not_empty();
+        slot(physical(size_ - 1)).~T();
+        --size_;
+    }
+
+    void pop_front()
+    {
+        check_not_empty();
+        slot(head_).~T();
+        const std::size_t next = static_cast<std::size_t>(head_) + 1;
+        head_ = static_cast<size_type>(next == capacity() ? 0 : next);
+        --size_;
+    }
+
+    void clear()
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            for (std::size_t i = 0; i < size_; ++i)
+            {
+                slot(physical(i)).~T();
+            }
+        }
+        head_ = 0;
+        size_ = 0;
+    }
+
+private:
+    struct HeapBuffer
+    {
+        T*            data = nullptr;
+        std::uint32_t capacity = 0;
+    };
+    struct NoHeap {};
+
+    // 先頭からの位置 → バッファ上の位置（割り算を使わずに折り返す）
+    std::size_t physical(std::size_t i) const
+    {
+        const std::size_t p = head_ + i;
+        const std::size_t cap = capacity();
+        return p >= cap ? p - cap : p;
+    }
+
+    void* raw(std::size_t physical_index)
+    {
+        if constexpr (Growable)
+        {
+            if (heap_.data != nullptr)
+            {
+                return heap_.data + physical_index;
+            }
+        }
+        return inline_ + physical_index * sizeof(T);
+    }
+
+    T& slot(std::size_t physical_index)
+    {
+        return *std::launder(static_cast<T*>(raw(physical_index)));
+    }
+
+    void check_not_empty() const
+    {
+        if (size_ == 0)
+        {
+            throw std::underflow_error("RingDeque が空です");
+        }
+    }
+
+    // 2倍の領域を用意し、position（0 か size_）に新しい要素を作ってから、残りの位置へ古い要素を写す
+    template<typename... Args>
+    T& grow_emplace(std::size_t position, Args&&... args)
+    {
+        if constexpr (Growable)
+        {
+            const std::size_t new_capacity = capacity() * 2;
+            T* fresh = std::allocator<T>().allocate(new_capacity);
+            T* p = nullptr;
+            try
+            {
+                p = ::new (fresh + position) T(std::forward<Args>(args)...);
+                transfer(fresh + (position == 0 ? 1 : 0));
+            }
+            catch (...)
+            {
+                if (p != nullptr)
+                {
+                    p->~T();
+                }
+                std::allocator<T>().deallocate(fresh, new_capacity);
+                throw;
+            }
+            adopt(fresh, new_capacity);
+            ++size_;
+            return *p;
+        }
+        else
+        {
+            throw std::length_error("RingDeque が満杯です");
+        }
+    }
+
+    // 空の自分へ other の中身を移す
+    void take_from(RingDeque&& other)
+    {
+        if constexpr (Growable)
+        {
+            if (other.heap_.data != nullptr)
+            {
+                // ヒープに出ていればポインタごと受け取る
+                release_heap();
+                heap_ = std::exchange(other.heap_, HeapBuffer{});
+                head_ = std::exchange(other.head_, 0);
+                size_ = std::exchange(other.size_, 0);
+                return;
+            }
+        }
+        for (T& value : other)
+        {
+            push_back(std::move(value));
+        }
+        other.clear();
+    }
+
+    void release_heap()
+    {
+        if constexpr (Growable)
+        {
+            if (heap_.data != nullptr)
+            {
+                std::allocator<T>().deallocate(heap_.data, heap_.capacity);
+                heap_ = HeapBuffer{};
+            }
+        }
+    }
+
+    // 新しいヒープ領域へ、先頭が 0 番になるよう並べ直して移す
+    void relocate(std::size_t new_capacity)
+    {
+        T* fresh = std::allocator<T>().allocate(new_capacity);
+        try
+        {
+            transfer(fresh);
+        }
+        catch (...)
+        {
+            std::allocator<T>().deallocate(fresh, new_capacity);
+            throw;
+        }
+        adopt(fresh, new_capacity);
+    }
+
+    // 全要素を dst[0, size_) へ写す。元の要素には手を付けないので、
+    // 途中でコピーが例外を投げても、写した分を捨てるだけで元のまま残る（強い保証）
+    void transfer(T* dst)
+    {
+        std::size_t done = 0;
+        try
+        {
+            for (; done < size_; ++done)
+            {
+                ::new (dst + done) T(std::move_if_noexcept(slot(physical(done))));
+            }
+        }
+        catch (...)
+        {
+            std::destroy_n(dst, done);
+            throw;
+        }
+    }
+
+    // 写し終えたあとで元の要素を片付け、新しい領域に乗り換える（ここから先は例外を投げない）
+    void adopt(T* fresh, std::size_t new_capacity)
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            for (std::size_t i = 0; i < size_; ++i)
+            {
+                slot(physical(i)).~T();
+            }
+        }
+        release_heap();
+        heap_.data = fresh;
+        heap_.capacity = static_cast<std::uint32_t>(new_capacity);
+        head_ = 0;
+    }
+
+    alignas(T) unsigned char inline_[N * sizeof(T)];
+    [[no_unique_address]] std::conditional_t<Growable, HeapBuffer, NoHeap> heap_;
+    size_type head_ = 0;
+    size_type size_ = 0;
+};
+
+static_assert(std::random_access_iterator<RingDeque<int, 4>::iterator>);
+
+// n 回目のコピーで例外を投げる型（ムーブは noexcept でないので、拡張ではコピーが使われる）
+struct Fragile
+{
+    static inline int fail_on_copy = 0;
+
+    int value;
+
+    explicit Fragile(int v) : value(v) {}
+    Fragile(const Fragile& other) : value(other.value)
+    {
+        if (fail_on_copy > 0 && --fail_on_copy == 0)
+        {
+            throw std::runtime_error("コピーに失敗しました");
+        }
+    }
+    Fragile(Fragile&& other) : value(other.value) {}
+};
+
+template<typename Party>
+void print_party(const char* title, const Party& party)
+{
+    std::cout << "=== " << title << " ===" << std::endl;
+    for (const auto& name : party)
+    {
+        std::cout << name << std::endl;
+    }
+}
+
+int main()
+{
+    // lesson25_3 と同じ操作を RingDeque で行う
+    std::size_t before = g_allocations;
+    RingDeque<std::string, 4> party;
+    party.push_back("勇者");
+    party.push_back("魔法使い");
+    party.push_back("僧侶");
+    party.push_front("盗賊");
+    print_party("パーティ", party);
+
+    std::cout << "\n先頭: " << party.front() << std::endl;
+    std::cout << "末尾: " << party.back() << std::endl;
+    std::cout << "2番目: " << party[1] << std::endl;
+
+    party.pop_front();
+    party.pop_back();
+    print_party("変更後のパーティ", party);
+    std::cout << "RingDeque のヒープ確保: " << g_allocations - before << "回" << std::endl;
+
+    // 満杯の固定容量版に追加すると例外になる
+    party.push_back("戦士");
+    party.push_back("商人");
+    try
+    {
+        party.push_back("遊び人");
+    }
+    catch (const std::length_error& e)
+    {
+        std::cout << "[length_error] " << e.what() << std::endl;
+    }
+
+    // std::deque との比較
+    before = g_allocations;
+    {
+        std::deque<std::string> std_party;
+        std_party.push_back("勇者");
+        std_party.push_back("魔法使い");
+        std_party.push_front("盗賊");
+    }
+    std::cout << "\nstd::deque のヒープ確保: " << g_allocations - before << "回" << std::endl;
+    std::cout << "sizeof(std::deque<int>):    " << sizeof(std::deque<int>) << std::endl;
+    std::cout << "sizeof(RingDeque<int, 8>):  " << sizeof(RingDeque<int, 8>) << std::endl;
+
+    // 伸びるモード：普段はインライン、あふれたときだけヒープへ
+    RingDeque<int, 4, true> actions;
+    for (int i = 0; i < 6; ++i)
+    {
+        actions.push_front(i);
+    }
+    std::sort(actions.begin(), actions.end()); // ランダムアクセスイテレータなので sort も使える
+    std::cout << "\n行動バッファ (容量 " << actions.capacity()
+              << (actions.is_inline() ? ", インライン" : ", ヒープ") << "):";
+    for (int a : actions)
+    {
+        std::cout << " " << a;
+    }
+    std::cout << std::endl;
+
+    // 満杯のときに自分の要素を渡しても、古い領域を片付ける前に新しい要素ができている
+    RingDeque<std::string, 2, true> log;
+    log.push_back("スライムがあらわれた！");
+    log.push_back("勇者のこうげき！");
+    log.push_back(log.front());  // 容量 2 → 4
+    log.push_back("スライムはにげだした");
+    log.push_front(log.back());  // 容量 4 → 8
+    std::cout << "\nログ (容量 " << log.capacity() << "):";
+    for (const auto& line : log)
+    {
+        std::cout << " [" << line << "]";
+    }
+    std::cout << std::endl;
+
+    // 拡張中にコピーが例外を投げても、元の要素はそのまま残る
+    RingDeque<Fragile, 2, true> fragile;
+    fragile.emplace_back(1);
+    fragile.emplace_back(2);
+    Fragile::fail_on_copy = 2;
+    try
+    {
+        fragile.emplace_back(3);
+    }
+    catch (const std::runtime_error& e)
+    {
+        std::cout << "[runtime_error] " << e.what() << " → 残った要素:";
+    }
+    for (const Fragile& f : fragile)
+    {
+        std::cout << " " << f.value;
+    }
+    std::cout << " (容量 " << fragile.capacity() << ")" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,294 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// --- コピーオンライト（COW）で共有するダメージ履歴 ---
+// lesson26_1 の EnemyData はコピーのたびに 10000 件の damage_log を丸ごと複製していた。
+// ここでは履歴を「固定サイズのチャンク」に分け、チャンクを参照カウントで共有する。
+//   - コピー：ポインタ1つ分（O(1)）
+//   - 書き換え：触ったチャンクだけを複製してから書き込む
+// スナップショットや AI の「もしも」シミュレーションのように、
+// コピーは多いが書き換えはわずか、という使い方に向いている
+//
+// スレッドについては std::vector と同じ約束になる：1つのオブジェクトを同時に触れるのは1スレッドだけだが、
+// コピーなら（チャンクを共有していても）別のスレッドへ渡して読み書きしてよい
+
+template<typename T, std::size_t ChunkSize = 1024>
+class CowLog
+{
+public:
+    CowLog() = default;
+
+    CowLog(std::size_t count, const T& value)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            push_back(value);
+        }
+    }
+
+    std::size_t size() const { return table_ ? table_->size : 0; }
+    bool        empty() const { return size() == 0; }
+
+    // 読み取りは共有したまま行える
+    const T& operator[](std::size_t i) const
+    {
+        return table_->chunks[i / ChunkSize]->items[i % ChunkSize];
+    }
+
+    // 書き換え：共有中なら、そのチャンクだけを自分専用に複製する
+    void set(std::size_t i, const T& value)
+    {
+        mutable_chunk(i / ChunkSize).items[i % ChunkSize] = value;
+    }
+
+    void push_back(const T& value)
+    {
+        const std::size_t n = size();
+        if (n % ChunkSize == 0)
+        {
+            mutable_table().chunks.push_back(Shared<Chunk>::make());
+        }
+        mutable_chunk(n / ChunkSize).items[n % ChunkSize] = value;
+        ++table_->size;
+    }
+
+    // チャンク単位でなめる（添字アクセスより速い）
+    template<typename Func>
+    void for_each(Func&& func) const
+    {
+        std::size_t remaining = size();
+        if (remaining == 0)
+        {
+            return;
+        }
+        for (const auto& chunk : table_->chunks)
+        {
+            const std::size_t n = remaining < ChunkSize ? remaining : ChunkSize;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                func(chunk->items[i]);
+            }
+            remaining -= n;
+        }
+    }
+
+    // 他のコピーと共有しているチャンク数（確認用）
+    std::size_t shared_chunks() const
+    {
+        std::size_t n = 0;
+        if (table_)
+        {
+            for (const auto& chunk : table_->chunks)
+            {
+                n += !chunk.unique() || !table_.unique();
+            }
+        }
+        return n;
+    }
+
+    std::size_t chunk_count() const { return table_ ? table_->chunks.size() : 0; }
+
+    // 何も共有していない複製を作る（中身を全部コピーするので O(n)。共有をやめたいとき用）
+    CowLog deep_copy() const
+    {
+        CowLog copy;
+        if (table_)
+        {
+            copy.table_ = Shared<Table>::make();
+            copy.table_->size = table_->size;
+            for (const auto& chunk : table_->chunks)
+            {
+                copy.table_->chunks.push_back(Shared<Chunk>::make(*chunk));
+            }
+        }
+        return copy;
+    }
+
+private:
+    // 参照カウント付きのポインタ。std::shared_ptr の use_count() は relaxed な読み取りで、
+    // 1 を見ても「別のスレッドのコピーが手放す前に行った読み取り」より後になる保証がない。
+    // ここでは参照を減らすときに release、数を調べるときに acquire を付けて、その順序を保証する
+    template<typename U>
+    class Shared
+    {
+    public:
+        Shared() = default;
+        Shared(const Shared& other) : node_(other.node_)
+        {
+            if (node_)
+            {
+                node_->owners.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        Shared(Shared&& other) noexcept : node_(std::exchange(other.node_, nullptr)) {}
+        Shared& operator=(Shared other) noexcept
+        {
+            std::swap(node_, other.node_);
+            return *this;
+        }
+        ~Shared()
+        {
+            if (node_ && node_->owners.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                delete node_;
+            }
+        }
+
+        template<typename... Args>
+        static Shared make(Args&&... args)
+        {
+            Shared p;
+            p.node_ = new Node(std::forward<Args>(args)...);
+            return p;
+        }
+
+        // 自分だけが持っているか。true なら、他のコピーが手放す前の読み書きはすべて済んでいる
+        bool unique() const { return node_->owners.load(std::memory_order_acquire) == 1; }
+
+        U&       operator*() const { return node_->value; }
+        U*       operator->() const { return &node_->value; }
+        explicit operator bool() const { return node_ != nullptr; }
+
+    private:
+        struct Node
+        {
+            template<typename... Args>
+            explicit Node(Args&&... args) : value(std::forward<Args>(args)...) {}
+
+            std::atomic<std::size_t> owners{ 1 };
+            U                        value;
+        };
+
+        Node* node_ = nullptr;
+    };
+
+    struct Chunk
+    {
+        std::array<T, ChunkSize> items{};
+    };
+
+    // チャンクへのポインタの一覧。これ自体も共有するので、コピーは table_ の参照カウントを増やすだけ
+    struct Table
+    {
+        std::vector<Shared<Chunk>> chunks;
+        std::size_t                         size = 0;
+    };
+
+    // 自分だけが持っていればそのまま書き、共有中なら複製してから書く
+    Table& mutable_table()
+    {
+        if (!table_)
+        {
+            table_ = Shared<Table>::make();
+        }
+        else if (!table_.unique())
+        {
+            table_ = Shared<Table>::make(*table_); // ポインタの一覧だけを複製（中身は共有のまま）
+        }
+        return *table_;
+    }
+
+    Chunk& mutable_chunk(std::size_t index)
+    {
+        Shared<Chunk>& chunk = mutable_table().chunks[index];
+        if (!chunk.unique())
+        {
+            chunk = Shared<Chunk>::make(*chunk); // 触ったチャンクだけを複製
+        }
+        return *chunk;
+    }
+
+    Shared<Table> table_;
+};
+
+struct EnemyData
+{
+    std::string   name;
+    CowLog<int>   damage_log; // コピーしても中身は共有される
+
+    EnemyData(std::string n, int log_size)
+        : name(std::move(n))
+        , damage_log(log_size, 10)
+    {
+        std::cout << "[コンストラクタ] " << name << std::endl;
+    }
+
+    EnemyData(const EnemyData& other)
+        : name(other.name)
+        , damage_log(other.damage_log) // ここは参照カウントを増やすだけ
+    {
+        std::cout << "[コピー] " << name << " (" << damage_log.size() << "件のデータを共有)" << std::endl;
+    }
+};
+
+// 値渡しでも、重い履歴は複製されない
+void process_copy(EnemyData data)
+{
+    std::cout << "処理中: " << data.name << " 共有チャンク " << data.damage_log.shared_chunks()
+              << " / " << data.damage_log.chunk_count() << std::endl;
+
+    // 「もしも」シミュレーション：コピー側だけ書き換える
+    data.damage_log.set(0, 999);
+    std::cout << "書き換え後: 共有チャンク " << data.damage_log.shared_chunks()
+              << " / " << data.damage_log.chunk_count() << std::endl;
+}
+
+int main()
+{
+    EnemyData enemy("ドラゴン", 10000);
+
+    std::cout << "\n--- 値渡し（COW なのでコピーは軽い）---" << std::endl;
+    process_copy(enemy);
+
+    // 元のデータは書き換わっていない
+    std::cout << "\nenemy の履歴[0]: " << enemy.damage_log[0] << std::endl;
+
+    // 別のスレッドへはコピーを渡すだけでよい（チャンクは共有したまま）
+    long long total = 0;
+    std::thread worker([log = enemy.damage_log, &total]() mutable
+        {
+            log.for_each([&total](int v) { total += v; });
+            log.set(2, 0); // 向こうで書き換えても、enemy 側には影響しない
+        });
+    enemy.damage_log.set(1, 50); // 並行して自分のほうを書き換えてよい
+    worker.join();
+    std::cout << "別スレッドでの合計: " << total << std::endl;
+
+    // --- std::vector との比較 ---
+    using Clock = std::chrono::steady_clock;
+    constexpr int COPIES = 10000;
+
+    std::vector<int> plain(10000, 10);
+    auto start = Clock::now();
+    long long checksum = 0;
+    for (int i = 0; i < COPIES; ++i)
+    {
+        std::vector<int> copy = plain;
+        copy[i % copy.size()] += 1;
+        checksum += copy[0];
+    }
+    auto vector_us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+    start = Clock::now();
+    for (int i = 0; i < COPIES; ++i)
+    {
+        CowLog<int> copy = enemy.damage_log;
+        copy.set(i % copy.size(), copy[i % copy.size()] + 1);
+        checksum += copy[0];
+    }
+    auto cow_us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+    std::cout << "\nコピー+1件書き換え x" << COPIES << std::endl;
+    std::cout << "std::vector: " << vector_us << "us" << std::endl;
+    std::cout << "CowLog:      " << cow_us << "us" << std::endl;
+    std::cout << "(checksum " << checksum << ")" << std::endl;
+
+    return 0;
+}
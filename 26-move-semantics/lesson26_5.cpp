@@ -0,0 +1,337 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// --- 圧縮した列指向のダメージ履歴 ---
+// lesson26_3 の damage_log は std::vector<int> で、同じ値（10）がずらっと並ぶ。
+// 追記専用のログを 128 件ずつのブロックに分け、ブロックごとに小さくなる方式を選んで保存する。
+//   - FOR（Frame Of Reference）: 最小値を引いて、残りを必要なビット数だけで詰める
+//   - RLE（ランレングス）      : (値, 連続回数) の組で持つ
+// ブロックごとに合計・最大値も持っておくので、sum / max / 区間集計はほとんど展開せずに答えられる。
+// -mavx2 をつけてコンパイルすると、FOR ブロックの展開に AVX2 を使う
+
+class CompressedLog
+{
+public:
+    static constexpr std::size_t BLOCK = 128;
+
+    void append(std::int32_t value)
+    {
+        tail_[tail_size_++] = value;
+        if (tail_size_ == BLOCK)
+        {
+            seal(tail_.data(), BLOCK);
+            tail_size_ = 0;
+        }
+    }
+
+    std::size_t size() const { return blocks_.size() * BLOCK + tail_size_; }
+
+    // 使っているメモリ（概算）
+    std::size_t memory_bytes() const
+    {
+        return blocks_.size() * sizeof(Block) + bytes_.size() + sizeof(tail_);
+    }
+
+    std::int64_t sum() const { return window_sum(0, size()); }
+    std::int32_t max() const { return window_max(0, size()); }
+
+    // [begin, end) の合計。丸ごと含まれるブロックは前計算した値を使う
+    std::int64_t window_sum(std::size_t begin, std::size_t end) const
+    {
+        std::int64_t total = 0;
+        visit(begin, end,
+              [&](const Block& b) { total += b.sum; },
+              [&](const std::int32_t* values, std::size_t n)
+              {
+                  total += std::accumulate(values, values + n, std::int64_t{ 0 });
+              });
+        return total;
+    }
+
+    std::int32_t window_max(std::size_t begin, std::size_t end) const
+    {
+        std::int32_t best = std::numeric_limits<std::int32_t>::min();
+        visit(begin, end,
+              [&](const Block& b) { best = std::max(best, b.max); },
+              [&](const std::int32_t* values, std::size_t n)
+              {
+                  best = std::max(best, *std::max_element(values, values + n));
+              });
+        return best;
+    }
+
+    // i 番目のブロックを展開する（戻り値は要素数）
+    std::size_t decode_block(std::size_t i, std::int32_t* out) const
+    {
+        const Block& b = blocks_[i];
+        const std::uint8_t* data = bytes_.data() + b.offset;
+        if (b.encoding == Encoding::Rle)
+        {
+            std::size_t n = 0;
+            for (std::uint32_t r = 0; r < b.runs; ++r)
+            {
+                std::int32_t value;
+                std::uint16_t count;
+                std::memcpy(&value, data + r * RUN_BYTES, sizeof(value));
+                std::memcpy(&count, data + r * RUN_BYTES + sizeof(value), sizeof(count));
+                std::fill_n(out + n, count, value);
+                n += count;
+            }
+            return n;
+        }
+        unpack(data, b.bit_width, b.min, out);
+        return BLOCK;
+    }
+
+    // 方式ごとのブロック数（確認用）
+    std::size_t count_blocks(bool rle) const
+    {
+        return static_cast<std::size_t>(std::count_if(blocks_.begin(), blocks_.end(),
+            [rle](const Block& b) { return (b.encoding == Encoding::Rle) == rle; }));
+    }
+
+private:
+    enum class Encoding : std::uint8_t { For, Rle };
+
+    struct Block
+    {
+        std::uint32_t offset;    // bytes_ 内の位置
+        Encoding      encoding;
+        std::uint8_t  bit_width; // FOR のときの1要素のビット数
+        std::uint16_t runs;      // RLE のときの組の数
+        std::int32_t  min;
+        std::int32_t  max;
+        std::int64_t  sum;
+    };
+
+    static constexpr std::size_t RUN_BYTES = sizeof(std::int32_t) + sizeof(std::uint16_t);
+    static constexpr std::size_t PADDING = 8; // 展開時にはみ出して読んでも安全なように
+
+    void seal(const std::int32_t* values, std::size_t n)
+    {
+        Block b{};
+        b.offset = static_cast<std::uint32_t>(bytes_.size());
+        b.min = *std::min_element(values, values + n);
+        b.max = *std::max_element(values, values + n);
+        b.sum = std::accumulate(values, values + n, std::int64_t{ 0 });
+
+        const auto range = static_cast<std::uint32_t>(static_cast<std::int64_t>(b.max) - b.min);
+        b.bit_width = static_cast<std::uint8_t>(std::bit_width(range));
+
+        std::size_t runs = 1;
+        for (std::size_t i = 1; i < n; ++i)
+        {
+            runs += values[i] != values[i - 1];
+        }
+
+        const std::size_t for_bytes = (n * b.bit_width + 7) / 8;
+        if (runs * RUN_BYTES < for_bytes)
+        {
+            b.encoding = Encoding::Rle;
+            b.runs = static_cast<std::uint16_t>(runs);
+            write_rle(values, n);
+        }
+        else
+        {
+            b.encoding = Encoding::For;
+            pack(values, n, b.bit_width, b.min);
+        }
+        blocks_.push_back(b);
+    }
+
+    void write_rle(const std::int32_t* values, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n;)
+        {
+            std::size_t j = i;
+            while (j < n && values[j] == values[i])
+            {
+                ++j;
+            }
+            const auto count = static_cast<std::uint16_t>(j - i);
+            std::uint8_t run[RUN_BYTES];
+            std::memcpy(run, &values[i], sizeof(std::int32_t));
+            std::memcpy(run + sizeof(std::int32_t), &count, sizeof(count));
+            bytes_.insert(bytes_.end(), run, run + RUN_BYTES);
+            i = j;
+        }
+    }
+
+    // value - min を bit_width ビットずつ詰める
+    void pack(const std::int32_t* values, std::size_t n, unsigned bit_width, std::int32_t min)
+    {
+        const std::size_t start = bytes_.size();
+        bytes_.resize(start + (n * bit_width + 7) / 8 + PADDING, 0);
+        if (bit_width == 0)
+        {
+            return; // 全部同じ値：最小値だけで表せる
+        }
+        std::uint8_t* out = bytes_.data() + start;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            // int32_t のまま引くと、INT32_MIN と INT32_MAX が同じブロックにあるとき桁あふれ（未定義動作）になる。
+            // uint32_t で引けば 2^32 を法とした差になり、範囲は 32 ビットに収まるので正しい値になる
+            const std::uint64_t v = static_cast<std::uint32_t>(values[i]) - static_cast<std::uint32_t>(min);
+            const std::size_t bit = i * bit_width;
+            std::uint64_t word;
+            std::memcpy(&word, out + bit / 8, sizeof(word));
+            word |= v << (bit % 8);
+            std::memcpy(out + bit / 8, &word, sizeof(word));
+        }
+    }
+
+    static void unpack(const std::uint8_t* data, unsigned bit_width, std::int32_t min, std::int32_t* out)
+    {
+        if (bit_width == 0)
+        {
+            std::fill_n(out, BLOCK, min);
+            return;
+        }
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        // 8要素ずつ：各要素の先頭バイトから32ビットを gather し、ビット単位のずれをシフトで直す
+        if (bit_width <= 25)
+        {
+            const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+            const __m256i width = _mm256_set1_epi32(static_cast<int>(bit_width));
+            const __m256i mask = _mm256_set1_epi32(static_cast<int>((1u << bit_width) - 1));
+            const __m256i base = _mm256_set1_epi32(min);
+            for (; i < BLOCK; i += 8)
+            {
+                const __m256i bit = _mm256_mullo_epi32(_mm256_add_epi32(lane, _mm256_set1_epi32(static_cast<int>(i))), width);
+                const __m256i bytes = _mm256_srli_epi32(bit, 3);
+                const __m256i shift = _mm256_and_si256(bit, _mm256_set1_epi32(7));
+                __m256i v = _mm256_i32gather_epi32(reinterpret_cast<const int*>(data), bytes, 1);
+                v = _mm256_and_si256(_mm256_srlv_epi32(v, shift), mask);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_add_epi32(v, base));
+            }
+            return;
+        }
+#endif
+        const std::uint64_t mask = (std::uint64_t{ 1 } << bit_width) - 1;
+        for (; i < BLOCK; ++i)
+        {
+            const std::size_t bit = i * bit_width;
+            std::uint64_t word;
+            std::memcpy(&word, data + bit / 8, sizeof(word));
+            out[i] = static_cast<std::int32_t>(((word >> (bit % 8)) & mask) + static_cast<std::uint32_t>(min));
+        }
+    }
+
+    // [begin, end) を、丸ごと含まれるブロック（on_block）と、一部だけ含まれる範囲（on_values）に分けて渡す
+    template<typename OnBlock, typename OnValues>
+    void visit(std::size_t begin, std::size_t end, OnBlock&& on_block, OnValues&& on_values) const
+    {
+        end = std::min(end, size());
+        std::array<std::int32_t, BLOCK> buffer;
+        while (begin < end)
+        {
+            const std::size_t block = begin / BLOCK;
+            const std::size_t first = begin % BLOCK;
+            const std::size_t count = std::min(BLOCK - first, end - begin);
+            if (block == blocks_.size())
+            {
+                on_values(tail_.data() + first, count); // まだ圧縮していない末尾
+            }
+            else if (first == 0 && count == BLOCK)
+            {
+                on_block(blocks_[block]);
+            }
+            else
+            {
+                decode_block(block, buffer.data());
+                on_values(buffer.data() + first, count);
+            }
+            begin += count;
+        }
+    }
+
+    std::vector<Block>                blocks_;
+    std::vector<std::uint8_t>         bytes_;
+    std::array<std::int32_t, BLOCK>   tail_{};
+    std::size_t                       tail_size_ = 0;
+};
+
+int main()
+{
+    // 戦闘ログのイメージ：ほとんど 10 ダメージ、たまにクリティカルや回復ブロック
+    constexpr std::size_t LOG_SIZE = 1'000'000;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> roll(0, 99);
+
+    std::vector<int> damage_log;
+    damage_log.reserve(LOG_SIZE);
+    CompressedLog compressed;
+    for (std::size_t i = 0; i < LOG_SIZE; ++i)
+    {
+        int damage = 10;
+        if ((i / 4096) % 3 == 1)
+        {
+            damage = 8 + roll(rng) % 8; // 乱戦区間：値がばらつく
+        }
+        else if (roll(rng) == 0)
+        {
+            damage = 45; // クリティカル
+        }
+        damage_log.push_back(damage);
+        compressed.append(damage);
+    }
+
+    std::cout << "件数: " << compressed.size() << std::endl;
+    std::cout << "std::vector<int>: " << damage_log.size() * sizeof(int) / 1024 << " KB" << std::endl;
+    std::cout << "CompressedLog:    " << compressed.memory_bytes() / 1024 << " KB"
+              << " (FOR " << compressed.count_blocks(false) << " / RLE " << compressed.count_blocks(true) << " ブロック)"
+              << std::endl;
+
+    // 集計は圧縮したまま答えられる
+    const long long plain_sum = std::accumulate(damage_log.begin(), damage_log.end(), 0LL);
+    std::cout << "\n合計: " << compressed.sum() << " (vector: " << plain_sum << ")" << std::endl;
+    std::cout << "最大: " << compressed.max()
+              << " (vector: " << *std::max_element(damage_log.begin(), damage_log.end()) << ")" << std::endl;
+
+    // 区間集計：直近 1000 件の合計と最大
+    const std::size_t b = LOG_SIZE - 1000;
+    const long long plain_window = std::accumulate(damage_log.begin() + b, damage_log.end(), 0LL);
+    std::cout << "直近1000件 合計: " << compressed.window_sum(b, LOG_SIZE)
+              << " (vector: " << plain_window << ") 最大: " << compressed.window_max(b, LOG_SIZE) << std::endl;
+
+    // 展開しても元の値に戻ることを確認
+    std::array<std::int32_t, CompressedLog::BLOCK> block;
+    bool ok = true;
+    for (std::size_t i = 0; i < LOG_SIZE / CompressedLog::BLOCK; ++i)
+    {
+        compressed.decode_block(i, block.data());
+        ok = ok && std::equal(block.begin(), block.end(), damage_log.begin() + i * CompressedLog::BLOCK);
+    }
+    // 値の範囲が int32_t の端から端まであるブロック（32 ビット幅の FOR になる）
+    std::vector<std::int32_t> extreme;
+    CompressedLog extreme_log;
+    for (std::size_t i = 0; i < CompressedLog::BLOCK * 2; ++i)
+    {
+        const std::int32_t v = i % 3 == 0 ? INT32_MIN : i % 3 == 1 ? INT32_MAX : static_cast<std::int32_t>(rng());
+        extreme.push_back(v);
+        extreme_log.append(v);
+    }
+    for (std::size_t i = 0; i < 2; ++i)
+    {
+        extreme_log.decode_block(i, block.data());
+        ok = ok && std::equal(block.begin(), block.end(), extreme.begin() + i * CompressedLog::BLOCK);
+    }
+    ok = ok && extreme_log.sum() == std::accumulate(extreme.begin(), extreme.end(), std::int64_t{ 0 });
+    std::cout << "展開結果の一致: " << (ok ? "OK" : "NG") << "（INT32_MIN〜INT32_MAX のブロックを含む）" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+#ifndef COPY_TRACKING
+#define COPY_TRACKING 1 // このサンプルでは計測を有効にする（-DCOPY_TRACKING=0 で消える）
+#endif
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "lesson26_6.hpp"
+
+// lesson26_1 / lesson26_3 の「[コピー]」「[ムーブ]」ログの代わりに、
+// Instrumented を継承するだけで回数とバイト数を数える
+struct EnemyData : Instrumented<EnemyData>
+{
+    std::string      name;
+    std::vector<int> damage_log;
+
+    EnemyData(std::string n, int log_size)
+        : name(std::move(n))
+        , damage_log(log_size, 10)
+    {}
+
+    // コピー時に実際に複製されるおおよそのバイト数
+    std::size_t copied_bytes() const
+    {
+        return sizeof(EnemyData) + name.size() + damage_log.size() * sizeof(int);
+    }
+    // コピー / ムーブは自分で書かなくてよい（基底クラスの分も自動で呼ばれる）
+};
+
+// lesson24_1 の Enemy
+struct Enemy : Instrumented<Enemy>
+{
+    std::string name;
+    int         hp;
+    int         attack;
+
+    Enemy(std::string n, int h, int a) : name(std::move(n)), hp(h), attack(a) {}
+};
+
+void process_copy(EnemyData data)
+{
+    std::cout << "処理中: " << data.name << std::endl;
+}
+
+void process_move(EnemyData&& data)
+{
+    EnemyData local = std::move(data);
+    std::cout << "処理中: " << local.name << std::endl;
+}
+
+int main()
+{
+    copy_stats::print_summary_at_exit();
+
+    EnemyData enemy("ドラゴン", 10000);
+    process_copy(enemy);            // コピー 1回
+    process_move(std::move(enemy)); // ムーブ 1回
+
+    std::vector<EnemyData> list;
+    list.reserve(2);
+    list.push_back(EnemyData("ゴブリン", 100)); // ムーブ
+    list.push_back(list[0]);                     // コピー
+
+    std::vector<Enemy> enemies = {
+        { "ゴブリン",  50, 10 },
+        { "オーク",   120, 25 },
+        { "スライム",  20,  5 },
+    }; // initializer_list からのコピーで 3回
+
+    // ❌ うっかりコピー：1周ごとに Enemy がコピーされる
+    for (auto e : enemies)
+    {
+        (void)e;
+    }
+
+    // 別スレッドでのコピーも、スレッドごとのカウンタで数えられる
+    std::thread worker([&enemies]()
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                Enemy copy = enemies[i % enemies.size()];
+                (void)copy;
+            }
+        });
+    worker.join();
+
+    std::cout << "\n=== 途中経過 ===" << std::endl;
+    copy_stats::print_summary();
+
+    std::cout << "\n=== 終了時（stderr）===" << std::endl;
+    return 0;
+}
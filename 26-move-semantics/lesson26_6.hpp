@@ -0,0 +1,223 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+// --- コピー / ムーブの計測用ミックスイン ---
+// 計測したい型に Instrumented<自分の型> を継承させるだけで、
+// コピー構築・ムーブ構築・代入の回数と、コピーしたバイト数を型ごとに数える。
+//
+//   struct EnemyData : Instrumented<EnemyData> { ... };
+//
+// COPY_TRACKING が 0（既定）のときは中身が空になり、サイズも速度も変わらない。
+// 本番ビルドで調べたいときは -DCOPY_TRACKING=1 をつけてコンパイルする。
+//
+// ⚠️ コピーコンストラクタを自分で書く場合は、基底クラスのコピーも呼ぶこと
+//   EnemyData(const EnemyData& other) : Instrumented(other), name(other.name) { ... }
+
+#ifndef COPY_TRACKING
+#define COPY_TRACKING 0
+#endif
+
+namespace copy_stats
+{
+    struct Counters
+    {
+        std::atomic<std::uint64_t> copy_construct{ 0 };
+        std::atomic<std::uint64_t> move_construct{ 0 };
+        std::atomic<std::uint64_t> copy_assign{ 0 };
+        std::atomic<std::uint64_t> move_assign{ 0 };
+        std::atomic<std::uint64_t> bytes_copied{ 0 };
+    };
+
+    // 書き込むのは持ち主のスレッドだけなので、read-modify-write 命令を使わずに足す
+    inline void bump(std::atomic<std::uint64_t>& counter, std::uint64_t n = 1)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    // 型ごと・スレッドごとのカウンタを持つ。スレッドが終わっても集計は残る
+    class Registry
+    {
+    public:
+        static Registry& instance()
+        {
+            static Registry registry;
+            return registry;
+        }
+
+        Counters& add_thread(const char* type_name)
+        {
+            std::lock_guard lock(mutex_);
+            entries_.push_back({ type_name, std::make_unique<Counters>() });
+            return *entries_.back().counters;
+        }
+
+        // 型ごとに全スレッド分を合計して表にする
+        void print(std::ostream& os) const
+        {
+            struct Row
+            {
+                std::string   name;
+                std::uint64_t values[5] = {};
+            };
+            std::vector<Row> rows;
+            {
+                std::lock_guard lock(mutex_);
+                for (const auto& e : entries_)
+                {
+                    auto it = rows.begin();
+                    while (it != rows.end() && it->name != e.type_name)
+                    {
+                        ++it;
+                    }
+                    if (it == rows.end())
+                    {
+                        rows.push_back({ e.type_name });
+                        it = rows.end() - 1;
+                    }
+                    const Counters& c = *e.counters;
+                    it->values[0] += c.copy_construct.load(std::memory_order_relaxed);
+                    it->values[1] += c.move_construct.load(std::memory_order_relaxed);
+                    it->values[2] += c.copy_assign.load(std::memory_order_relaxed);
+                    it->values[3] += c.move_assign.load(std::memory_order_relaxed);
+                    it->values[4] += c.bytes_copied.load(std::memory_order_relaxed);
+                }
+            }
+
+            os << std::left << std::setw(24) << "type"
+               << std::right << std::setw(10) << "copy" << std::setw(10) << "move"
+               << std::setw(10) << "copy=" << std::setw(10) << "move=" << std::setw(14) << "bytes" << "\n";
+            for (const auto& r : rows)
+            {
+                os << std::left << std::setw(24) << r.name << std::right;
+                for (int i = 0; i < 4; ++i)
+                {
+                    os << std::setw(10) << r.values[i];
+                }
+                os << std::setw(14) << r.values[4] << "\n";
+            }
+        }
+
+    private:
+        struct Entry
+        {
+            std::string               type_name;
+            std::unique_ptr<Counters> counters;
+        };
+
+        mutable std::mutex mutex_;
+        std::vector<Entry> entries_;
+    };
+
+    template<typename T>
+    std::string type_name()
+    {
+#if defined(__GNUG__)
+        int status = 0;
+        std::unique_ptr<char, void (*)(void*)> demangled(
+            abi::__cxa_demangle(typeid(T).name(), nullptr, nullptr, &status), std::free);
+        if (status == 0)
+        {
+            return demangled.get();
+        }
+#endif
+        return typeid(T).name();
+    }
+
+    // 呼び出したスレッド専用のカウンタ（初回だけ登録する）
+    template<typename T>
+    Counters& local()
+    {
+        static const std::string name = type_name<T>();
+        thread_local Counters& counters = Registry::instance().add_thread(name.c_str());
+        return counters;
+    }
+
+    // いつでも集計を出力できる
+    inline void print_summary(std::ostream& os = std::cout)
+    {
+        Registry::instance().print(os);
+    }
+
+    // プログラム終了時に集計を出力する
+    inline void print_summary_at_exit()
+    {
+        Registry::instance(); // 先に作っておくと、終了時の出力より後に破棄される
+        std::atexit([]() { print_summary(std::cerr); });
+    }
+}
+
+#if COPY_TRACKING
+
+template<typename Derived>
+class Instrumented
+{
+public:
+    Instrumented() = default;
+
+    Instrumented(const Instrumented& other) noexcept
+    {
+        auto& c = copy_stats::local<Derived>();
+        copy_stats::bump(c.copy_construct);
+        copy_stats::bump(c.bytes_copied, bytes_of(other));
+    }
+
+    Instrumented(Instrumented&&) noexcept
+    {
+        copy_stats::bump(copy_stats::local<Derived>().move_construct);
+    }
+
+    Instrumented& operator=(const Instrumented& other) noexcept
+    {
+        auto& c = copy_stats::local<Derived>();
+        copy_stats::bump(c.copy_assign);
+        copy_stats::bump(c.bytes_copied, bytes_of(other));
+        return *this;
+    }
+
+    Instrumented& operator=(Instrumented&&) noexcept
+    {
+        copy_stats::bump(copy_stats::local<Derived>().move_assign);
+        return *this;
+    }
+
+private:
+    // コピー元はすでに完成した Derived なので、Derived として中身の大きさを聞ける
+    // Derived が copied_bytes() を持っていればそれを、なければ sizeof を使う
+    static std::uint64_t bytes_of(const Instrumented& other)
+    {
+        const Derived& source = static_cast<const Derived&>(other);
+        if constexpr (requires { source.copied_bytes(); })
+        {
+            return source.copied_bytes();
+        }
+        else
+        {
+            return sizeof(Derived);
+        }
+    }
+};
+
+#else
+
+// 計測なし：空の基底クラス（空基底最適化でサイズは増えない）
+template<typename Derived>
+class Instrumented
+{
+};
+
+#endif
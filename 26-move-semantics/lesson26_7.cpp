@@ -0,0 +1,400 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// --- ロールバック用のスナップショット（変わったブロックだけを memcpy する） ---
+// ロールバック方式のネット対戦では、相手の入力が遅れて届くたびに
+// 「数フレーム前の状態に戻して、そこから計算し直す」ことを1フレームに何回も行う。
+// lesson26_1 の EnemyData のように std::string や std::vector を持つ型だと、
+// 保存のたびにメンバごとのコピー（とメモリ確保）が走る。
+//
+// ここでは状態を「トリビアルコピー可能な型の列」だけで持ち、1つの領域にまとめて置く。
+//   - 領域を BlockBytes ごとのブロックに分け、書き込んだブロックに印を付ける（ダーティフラグ）
+//   - save()     … 印の付いたブロックだけ、「前回の保存時点の中身」をフレームのリングに memcpy する
+//   - rollback() … 戻る先より後のフレームから、ブロックごとに一番古い中身を1回だけ書き戻す
+// 保存も巻き戻しも、変わったバイト数に比例する時間で済む。
+// フレームの領域は最初にまとめて確保するので、毎フレームのメモリ確保もない
+//
+// ⚠️ 印を付けるのは write() を通した書き込みだけ。data() から直接書き換えた場合は mark_all() を呼ぶこと
+
+template<std::size_t Frames = 8, std::size_t BlockBytes = 4096>
+class RollbackArena
+{
+    static_assert((BlockBytes & (BlockBytes - 1)) == 0, "BlockBytes は2のべき乗にする");
+    static constexpr std::size_t ALIGN = 64;
+
+public:
+    // 1種類の値の列。中身は RollbackArena の領域の中にある
+    template<typename T>
+    class Column
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "memcpy で保存できる型だけを置ける");
+
+    public:
+        std::size_t size() const { return size_; }
+        const T&    operator[](std::size_t i) const { return data_[i]; }
+        const T*    data() const { return data_; }
+
+        // 書き換える要素のブロックに印を付けてから参照を返す。
+        // 要素がブロックの境目をまたぐこともあるので、先頭と末尾の両方に付ける
+        T& write(std::size_t i)
+        {
+            const std::size_t first = offset_ + i * sizeof(T);
+            dirty_[first / BlockBytes] = 1;
+            dirty_[(first + sizeof(T) - 1) / BlockBytes] = 1;
+            return data_[i];
+        }
+
+    private:
+        friend class RollbackArena;
+        Column(T* data, std::size_t size, std::size_t offset, std::uint8_t* dirty)
+            : data_(data), size_(size), offset_(offset), dirty_(dirty)
+        {
+        }
+
+        T*            data_;
+        std::size_t   size_;
+        std::size_t   offset_; // 領域の先頭からのバイト数
+        std::uint8_t* dirty_;
+    };
+
+    // capacity バイトまでの列を置ける。リングのフレームもこの大きさで確保する
+    explicit RollbackArena(std::size_t capacity)
+        : capacity_((capacity + BlockBytes - 1) / BlockBytes * BlockBytes)
+        , live_(new (std::align_val_t{ ALIGN }) std::byte[capacity_])
+        , shadow_(std::make_unique_for_overwrite<std::byte[]>(capacity_))
+        , frame_bytes_(std::make_unique_for_overwrite<std::byte[]>(capacity_ * Frames))
+        , dirty_(capacity_ / BlockBytes, 0)
+        , restored_(dirty_.size(), 0)
+    {
+        for (Frame& frame : frames_)
+        {
+            frame.blocks.reserve(dirty_.size());
+        }
+    }
+
+    ~RollbackArena() { ::operator delete[](live_, std::align_val_t{ ALIGN }); }
+
+    RollbackArena(const RollbackArena&) = delete;
+    RollbackArena& operator=(const RollbackArena&) = delete;
+
+    // 最初の save() より前に、必要な列をすべて作っておく
+    template<typename T>
+    Column<T> make_column(std::size_t count, const T& value = T{})
+    {
+        if (based_)
+        {
+            throw std::logic_error("save() の後で列は増やせない");
+        }
+        const std::size_t offset = (used_ + alignof(T) - 1) / alignof(T) * alignof(T);
+        if (offset + count * sizeof(T) > capacity_)
+        {
+            throw std::length_error("RollbackArena の容量が足りない");
+        }
+        T* data = reinterpret_cast<T*>(live_ + offset);
+        std::uninitialized_fill_n(data, count, value);
+        used_ = offset + count * sizeof(T);
+        return Column<T>(data, count, offset, dirty_.data());
+    }
+
+    // 今の状態を保存し、そのティック番号を返す（最初の呼び出しは 0）
+    std::uint32_t save()
+    {
+        if (!based_)
+        {
+            std::memcpy(shadow_.get(), live_, used_);
+            std::fill(dirty_.begin(), dirty_.end(), 0);
+            based_ = true;
+            return tick_;
+        }
+
+        ++tick_;
+        Frame& frame = frames_[tick_ % Frames];
+        frame.blocks.clear();
+        std::byte* out = frame_bytes_.get() + (tick_ % Frames) * capacity_;
+        for (std::uint32_t b = 0; b < dirty_.size(); ++b)
+        {
+            if (!dirty_[b])
+            {
+                continue;
+            }
+            dirty_[b] = 0;
+            const std::size_t at = std::size_t{ b } * BlockBytes;
+            const std::size_t n = block_size(b);
+            std::memcpy(out, shadow_.get() + at, n); // 前回の保存時点の中身
+            std::memcpy(shadow_.get() + at, live_ + at, n); // shadow_ は常に最新の保存時点と同じにしておく
+            frame.blocks.push_back(b);
+            out += n;
+        }
+        if (tick_ - oldest_ > Frames)
+        {
+            ++oldest_; // リングから押し出されたフレームへは戻れない
+        }
+        return tick_;
+    }
+
+    std::uint32_t latest() const { return tick_; }
+    std::uint32_t oldest() const { return oldest_; }
+
+    // tick の保存時点の状態に戻す（save() していない書き込みも捨てる）。
+    // 戻したティックより新しい保存は消えるので、次の save() は tick + 1 になる
+    void rollback(std::uint32_t tick)
+    {
+        if (!based_ || tick < oldest_ || tick > tick_)
+        {
+            throw std::out_of_range("リングにないティックには戻れない");
+        }
+        // tick の時点のブロックの中身は、tick より後で最初にそのブロックを保存したフレームにある。
+        // 古いフレームから順に見て、各ブロックは最初に見つけた1回だけ書き戻す
+        // （8ティック続けて同じブロックを書き換えていても、コピーは1回で済む）
+        for (std::uint32_t t = tick + 1; t <= tick_; ++t)
+        {
+            const Frame& frame = frames_[t % Frames];
+            const std::byte* in = frame_bytes_.get() + (t % Frames) * capacity_;
+            for (std::uint32_t b : frame.blocks)
+            {
+                const std::size_t n = block_size(b);
+                if (!restored_[b])
+                {
+                    restored_[b] = 1;
+                    const std::size_t at = std::size_t{ b } * BlockBytes;
+                    std::memcpy(live_ + at, in, n);
+                    std::memcpy(shadow_.get() + at, in, n);
+                }
+                in += n;
+            }
+        }
+        // 最後の save() より後にだけ書き換えたブロックは shadow_ から戻す
+        for (std::uint32_t b = 0; b < dirty_.size(); ++b)
+        {
+            if (dirty_[b] && !restored_[b])
+            {
+                const std::size_t at = std::size_t{ b } * BlockBytes;
+                std::memcpy(live_ + at, shadow_.get() + at, block_size(b));
+            }
+            dirty_[b] = 0;
+            restored_[b] = 0;
+        }
+        tick_ = tick;
+    }
+
+    // data() 経由で印を付けずに書き換えたとき用
+    void mark_all() { std::fill(dirty_.begin(), dirty_.end(), 1); }
+
+    std::size_t used_bytes() const { return used_; }
+
+    // 直近の保存でフレームに書いたバイト数（確認用）
+    std::size_t last_saved_bytes() const
+    {
+        std::size_t n = 0;
+        for (std::uint32_t b : frames_[tick_ % Frames].blocks)
+        {
+            n += block_size(b);
+        }
+        return n;
+    }
+
+private:
+    struct Frame
+    {
+        std::vector<std::uint32_t> blocks; // 中身を保存したブロックの番号（フレームの領域に順に詰めてある）
+    };
+
+    // 使っている範囲の外は写さない（末尾のブロックは途中までのことがある）
+    std::size_t block_size(std::uint32_t b) const
+    {
+        const std::size_t at = std::size_t{ b } * BlockBytes;
+        return at >= used_ ? 0 : std::min(BlockBytes, used_ - at);
+    }
+
+    std::size_t                  capacity_;
+    std::size_t                  used_ = 0;
+    std::byte*                   live_;
+    std::unique_ptr<std::byte[]> shadow_;
+    std::unique_ptr<std::byte[]> frame_bytes_; // Frames 個のフレームの領域を1回で確保する
+    std::vector<std::uint8_t>    dirty_;
+    std::vector<std::uint8_t>    restored_; // rollback() の中だけで使う
+    Frame                        frames_[Frames];
+    std::uint32_t                tick_ = 0;
+    std::uint32_t                oldest_ = 0;
+    bool                         based_ = false;
+};
+
+// --- 状態：すべてトリビアルコピー可能な型 ---
+struct Position
+{
+    float x, y;
+};
+
+struct Velocity
+{
+    float x, y;
+};
+
+struct Health
+{
+    std::int32_t hp, max_hp;
+};
+
+// 比較用：lesson26_1 のように string と unique_ptr を持つ敵
+struct EnemyObject
+{
+    std::string               name;
+    Position                  pos;
+    Velocity                  vel;
+    std::unique_ptr<Health>   health;
+
+    EnemyObject() = default;
+    EnemyObject(const EnemyObject& other)
+        : name(other.name), pos(other.pos), vel(other.vel), health(std::make_unique<Health>(*other.health))
+    {
+    }
+    EnemyObject& operator=(const EnemyObject& other)
+    {
+        name = other.name;
+        pos = other.pos;
+        vel = other.vel;
+        *health = *other.health;
+        return *this;
+    }
+};
+
+using Arena = RollbackArena<8, 4096>;
+
+struct World
+{
+    Arena::Column<Position> pos;
+    Arena::Column<Velocity> vel;
+    Arena::Column<Health>   health;
+};
+
+// 1ティック進める。動いているのは moving 体だけで、HP が減るのは hits 体だけ
+void step(World& w, std::uint32_t tick, std::size_t moving, std::size_t hits)
+{
+    for (std::size_t i = 0; i < moving; ++i)
+    {
+        Position& p = w.pos.write(i);
+        p.x += w.vel[i].x;
+        p.y += w.vel[i].y;
+    }
+    for (std::size_t k = 0; k < hits; ++k)
+    {
+        const std::size_t i = (tick * 7919u + k * 104729u) % w.health.size();
+        Health& h = w.health.write(i);
+        h.hp = std::max(0, h.hp - 3);
+    }
+}
+
+// 状態全体の確認用のコピー
+std::vector<std::byte> dump(const Arena& arena, const World& w)
+{
+    const auto* begin = reinterpret_cast<const std::byte*>(w.pos.data());
+    return std::vector<std::byte>(begin, begin + arena.used_bytes());
+}
+
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+    constexpr std::size_t ENTITIES = 100'000;
+    constexpr std::size_t MOVING = 10'000; // 群衆のうち、このティックに動いている数
+    constexpr std::size_t HITS = 200;
+    constexpr int ROUNDS = 200;
+
+    Arena arena(ENTITIES * (sizeof(Position) + sizeof(Velocity) + sizeof(Health)) + 4096);
+    World w{ arena.make_column<Position>(ENTITIES), arena.make_column<Velocity>(ENTITIES),
+             arena.make_column<Health>(ENTITIES, Health{ 100, 100 }) };
+    for (std::size_t i = 0; i < ENTITIES; ++i)
+    {
+        w.vel.write(i) = Velocity{ 0.5f + static_cast<float>(i % 7), -1.0f };
+    }
+    arena.save();
+    std::cout << "状態 " << arena.used_bytes() / 1024 << "KB（" << ENTITIES << "体）\n";
+
+    // --- 正しく戻るか：各ティックの全体コピーと比べる ---
+    {
+        std::vector<std::vector<std::byte>> expected{ dump(arena, w) };
+        for (std::uint32_t t = 1; t <= 20; ++t)
+        {
+            step(w, t, MOVING, HITS);
+            arena.save();
+            expected.push_back(dump(arena, w));
+        }
+        step(w, 21, MOVING, HITS); // 保存していない書き込みも捨てられる
+        bool ok = true;
+        for (std::uint32_t back : { 3u, 8u })
+        {
+            const std::uint32_t target = arena.latest() - back;
+            arena.rollback(target);
+            ok &= dump(arena, w) == expected[target];
+            // 戻した先から計算し直すと、同じ結果になる
+            for (std::uint32_t t = target + 1; t < expected.size(); ++t)
+            {
+                step(w, t, MOVING, HITS);
+                arena.save();
+                ok &= dump(arena, w) == expected[t];
+            }
+        }
+        std::cout << "巻き戻しと再計算: " << (ok ? "一致" : "不一致!") << "（戻れるのは "
+                  << arena.latest() - arena.oldest() << " ティック前まで）\n";
+    }
+
+    // --- 速さ：1ティックの保存と、8ティック分の巻き戻し ---
+    long long save_ns = 0, rollback_ns = 0;
+    std::size_t saved_bytes = 0;
+    for (int r = 0; r < ROUNDS; ++r)
+    {
+        for (int t = 0; t < 8; ++t)
+        {
+            step(w, arena.latest() + 1, MOVING, HITS);
+            const auto start = Clock::now();
+            arena.save();
+            save_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+            saved_bytes += arena.last_saved_bytes();
+        }
+        const auto start = Clock::now();
+        arena.rollback(arena.latest() - 8);
+        rollback_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    }
+
+    // 比較：毎ティック全体を memcpy する
+    std::vector<std::byte> full_ring(arena.used_bytes() * 8);
+    auto start = Clock::now();
+    for (int r = 0; r < ROUNDS * 8; ++r)
+    {
+        std::memcpy(full_ring.data() + (r % 8) * arena.used_bytes(), w.pos.data(), arena.used_bytes());
+    }
+    const long long full_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+    // 比較：string と unique_ptr を持つオブジェクトの配列をコピーする
+    std::vector<EnemyObject> objects(ENTITIES);
+    for (std::size_t i = 0; i < ENTITIES; ++i)
+    {
+        objects[i].name = "スライム" + std::to_string(i);
+        objects[i].health = std::make_unique<Health>(Health{ 100, 100 });
+    }
+    std::vector<std::vector<EnemyObject>> object_ring(8);
+    start = Clock::now();
+    for (int r = 0; r < 8; ++r)
+    {
+        object_ring[r] = objects; // 最初はメモリ確保、2周目以降も文字列とHPをメンバごとにコピー
+    }
+    const long long object_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+    std::cout << "\n" << MOVING << "体が移動、" << HITS << "体が被弾するティックを8回保存して、8ティック巻き戻す x" << ROUNDS << "\n";
+    std::cout << "  保存（変わったブロックだけ）:  " << save_ns / (ROUNDS * 8) << "ns/ティック（"
+              << saved_bytes / (ROUNDS * 8) / 1024 << "KB）\n";
+    std::cout << "  8ティック巻き戻し:             " << rollback_ns / ROUNDS << "ns\n";
+    std::cout << "  全体を memcpy:                 " << full_ns / (ROUNDS * 8) << "ns/ティック（"
+              << arena.used_bytes() / 1024 << "KB）\n";
+    std::cout << "  string + unique_ptr のコピー:  " << object_ns / 8 << "ns/ティック\n";
+    return 0;
+}
@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// --- メモリマップによるゼロコピーのファイル読み込み（Linux / POSIX） ---
+// lesson27_1 の load_file_exception は istreambuf_iterator で1文字ずつ std::string にコピーする。
+// MappedFile はファイルを mmap で読み取り専用のメモリとして見せるだけなので、コピーが起きない。
+// 必要なページだけが OS によって読み込まれる。
+// 失敗したときは load_file_exception と同じく std::runtime_error を投げる
+
+class MappedFile
+{
+public:
+    // OS へのアクセスパターンのヒント（madvise）
+    enum class Access
+    {
+        Normal,
+        Sequential, // 先頭から順に読む：先読みを増やし、読み終えたページは早めに捨ててよい
+        Random,     // あちこち読む：先読みしない
+        WillNeed,   // すぐに全部使う：今のうちに読み込みを始めてほしい
+    };
+
+    explicit MappedFile(const std::string& path, Access access = Access::Normal)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            throw std::runtime_error("ファイルを開けませんでした: " + path);
+        }
+
+        struct stat st{};
+        if (::fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("ファイルの情報を取得できませんでした: " + path);
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+
+        // サイズ 0 のファイルは mmap できないので、空のビューとして扱う
+        if (size_ > 0)
+        {
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED)
+            {
+                const int error = errno; // close() で上書きされる前に取っておく
+                ::close(fd);
+                throw std::runtime_error("ファイルをマップできませんでした: " + path + " (" + std::strerror(error) + ")");
+            }
+            data_ = static_cast<const std::byte*>(p);
+        }
+        ::close(fd); // マップした後はファイルディスクリプタを閉じてもよい
+
+        advise(access);
+    }
+
+    ~MappedFile()
+    {
+        unmap();
+    }
+
+    // コピーは禁止、ムーブだけ許可（所有権は1つ）
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr))
+        , size_(std::exchange(other.size_, 0))
+    {}
+
+    MappedFile& operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            unmap();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    std::size_t size() const { return size_; }
+
+    std::span<const std::byte> bytes() const { return { data_, size_ }; }
+
+    std::string_view text() const
+    {
+        return { reinterpret_cast<const char*>(data_), size_ };
+    }
+
+    // 全体、または一部の範囲にヒントを出し直す
+    void advise(Access access, std::size_t offset = 0, std::size_t length = 0) const
+    {
+        if (data_ == nullptr || access == Access::Normal || offset >= size_)
+        {
+            return; // 範囲がファイルの外なら、ヒントを出すものがない
+        }
+        // madvise の開始位置はページ境界にそろえる必要がある
+        const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        const std::size_t begin = offset / page * page;
+        const std::size_t end = length == 0 ? size_ : offset + std::min(length, size_ - offset); // offset + length のあふれも避ける
+        ::madvise(const_cast<std::byte*>(data_) + begin, end - begin, to_native(access));
+        // ヒントなので失敗しても読み込み自体には影響しない
+    }
+
+private:
+    static int to_native(Access access)
+    {
+        switch (access)
+        {
+        case Access::Sequential: return MADV_SEQUENTIAL;
+        case Access::Random:     return MADV_RANDOM;
+        case Access::WillNeed:   return MADV_WILLNEED;
+        default:                 return MADV_NORMAL;
+        }
+    }
+
+    void unmap()
+    {
+        if (data_ != nullptr)
+        {
+            ::munmap(const_cast<std::byte*>(data_), size_);
+            data_ = nullptr;
+        }
+    }
+
+    const std::byte* data_ = nullptr;
+    std::size_t      size_ = 0;
+};
+
+// 比較用：lesson27_1 と同じ読み込み方
+std::string load_file_exception(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("ファイルを開けませんでした: " + path);
+    }
+    return { std::istreambuf_iterator<char>(file),
+             std::istreambuf_iterator<char>() };
+}
+
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+    const std::string path = "asset_test.txt";
+
+    // テスト用の大きなアセットファイル（約 30MB）を作る
+    {
+        std::ofstream out(path, std::ios::binary);
+        const std::string line = "enemy,goblin,50,10,スライムより少し強い\n";
+        for (int i = 0; i < 600000; ++i)
+        {
+            out << line;
+        }
+    }
+
+    // 従来の読み込み
+    auto start = Clock::now();
+    const std::string text = load_file_exception(path);
+    const auto lines_copy = std::count(text.begin(), text.end(), '\n');
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+    std::cout << "istreambuf_iterator: " << ms << "ms (" << lines_copy << "行)" << std::endl;
+
+    // メモリマップ：先頭から順に読むので Sequential を指定
+    start = Clock::now();
+    {
+        MappedFile file(path, MappedFile::Access::Sequential);
+        const std::string_view view = file.text();
+        const auto lines_mapped = std::count(view.begin(), view.end(), '\n');
+        ms = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+        std::cout << "MappedFile:          " << ms << "ms (" << lines_mapped << "行, "
+                  << file.bytes().size() << "バイト)" << std::endl;
+
+        // string_view なので、部分文字列もコピーなしで取り出せる
+        std::cout << "先頭の行: " << view.substr(0, view.find('\n')) << std::endl;
+    } // スコープを抜けると munmap される
+
+    // 失敗時の例外は load_file_exception と同じ
+    try
+    {
+        MappedFile missing("data.txt");
+        std::cout << "読み込み成功: " << missing.size() << "文字" << std::endl;
+    }
+    catch (const std::runtime_error& e)
+    {
+        std::cerr << "エラー: " << e.what() << std::endl;
+    }
+
+    std::remove(path.c_str());
+    return 0;
+}
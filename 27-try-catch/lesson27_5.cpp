@@ -0,0 +1,493 @@
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+// --- バージョンつきバイナリセーブ形式と、セクションごとのチェックサム ---
+// lesson27_3 の load_save_data は「壊れている」ことを仮のフラグで表していた。
+// ここでは実際のバイナリ形式を作る。
+//
+//   [ヘッダ] magic, version, セクション数, ヘッダ自身の CRC
+//   [セクション表] id, 位置, サイズ, 件数, CRC32C
+//   [セクション本体] 固定レイアウトの構造体の配列（mmap したメモリをそのまま読める）
+//
+// CRC32C は SSE4.2 の crc32 命令（-msse4.2）で計算し、なければソフトウェア版を使う。
+// 読み込み時は全セクションの検証を並列に始め、使いたいセクションの検証が終わった時点で使える。
+// チェックサムが合わなければ、どのセクションが壊れているかを持った SaveDataCorruptedError を投げる
+
+static_assert(std::endian::native == std::endian::little, "リトルエンディアン前提の形式");
+
+// ゲーム固有のエラークラス（lesson27_3 と同じ）
+class GameError : public std::runtime_error
+{
+public:
+    explicit GameError(const std::string& message)
+        : std::runtime_error("[GameError] " + message)
+    {}
+};
+
+class SaveDataCorruptedError : public GameError
+{
+public:
+    SaveDataCorruptedError(const std::string& save_path, const std::string& section)
+        : GameError("セーブデータが壊れています: " + save_path + " (セクション: " + section + ")")
+        , save_path_(save_path)
+        , section_(section)
+    {}
+
+    const std::string& save_path() const { return save_path_; }
+    const std::string& section() const { return section_; }
+
+private:
+    std::string save_path_;
+    std::string section_;
+};
+
+// --- CRC32C ---
+namespace crc32c
+{
+    constexpr std::uint32_t POLY = 0x82F63B78; // Castagnoli 多項式（ビット反転表現）
+
+    constexpr std::array<std::uint32_t, 256> make_table()
+    {
+        std::array<std::uint32_t, 256> table{};
+        for (std::uint32_t i = 0; i < 256; ++i)
+        {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; ++k)
+            {
+                c = (c & 1) ? (c >> 1) ^ POLY : c >> 1;
+            }
+            table[i] = c;
+        }
+        return table;
+    }
+
+    constexpr auto TABLE = make_table();
+
+    inline std::uint32_t compute(std::span<const std::byte> data)
+    {
+        std::uint32_t crc = 0xFFFFFFFF;
+        const std::byte* p = data.data();
+        std::size_t n = data.size();
+#if defined(__SSE4_2__)
+        // 8バイトずつハードウェアで計算
+        std::uint64_t crc64 = crc;
+        for (; n >= 8; n -= 8, p += 8)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, p, sizeof(word));
+            crc64 = _mm_crc32_u64(crc64, word);
+        }
+        crc = static_cast<std::uint32_t>(crc64);
+        for (; n > 0; --n, ++p)
+        {
+            crc = _mm_crc32_u8(crc, static_cast<std::uint8_t>(*p));
+        }
+#else
+        for (; n > 0; --n, ++p)
+        {
+            crc = TABLE[(crc ^ static_cast<std::uint8_t>(*p)) & 0xFF] ^ (crc >> 8);
+        }
+#endif
+        return crc ^ 0xFFFFFFFF;
+    }
+}
+
+// --- ファイル形式 ---
+constexpr std::uint32_t SAVE_MAGIC = 0x534E4254; // "TBNS"
+constexpr std::uint16_t SAVE_VERSION = 2;
+constexpr std::size_t   SECTION_ALIGN = 16;   // セクション本体の先頭をそろえる
+
+constexpr std::uint32_t fourcc(const char (&s)[5])
+{
+    return static_cast<std::uint32_t>(s[0]) | static_cast<std::uint32_t>(s[1]) << 8
+         | static_cast<std::uint32_t>(s[2]) << 16 | static_cast<std::uint32_t>(s[3]) << 24;
+}
+
+struct FileHeader
+{
+    std::uint32_t magic;
+    std::uint16_t version;
+    std::uint16_t section_count;
+    std::uint32_t table_crc; // セクション表の CRC
+    std::uint32_t header_crc; // この構造体（header_crc = 0 として）の CRC
+};
+
+struct SectionEntry
+{
+    std::uint32_t id;
+    std::uint32_t record_count;
+    std::uint64_t offset;
+    std::uint64_t size;
+    std::uint32_t crc;
+    std::uint32_t reserved;
+};
+
+// セクション本体に入れる固定レイアウトのレコード
+struct PlayerRecord
+{
+    char          name[16];
+    std::int32_t  hp;
+    std::int32_t  max_hp;
+    std::int32_t  level;
+    std::uint32_t play_seconds;
+};
+
+struct EntityRecord
+{
+    std::uint32_t id;
+    std::int32_t  hp;
+    float         x;
+    float         y;
+    std::uint16_t type;
+    std::uint16_t flags;
+};
+
+static_assert(std::is_trivially_copyable_v<PlayerRecord> && std::is_standard_layout_v<PlayerRecord>);
+static_assert(std::is_trivially_copyable_v<EntityRecord> && std::is_standard_layout_v<EntityRecord>);
+
+// --- 書き込み ---
+class SaveWriter
+{
+public:
+    template<typename T>
+    void add_section(const char (&id)[5], std::span<const T> records)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const auto bytes = std::as_bytes(records);
+        sections_.push_back({ fourcc(id), static_cast<std::uint32_t>(records.size()),
+                              std::vector<std::byte>(bytes.begin(), bytes.end()) });
+    }
+
+    void write(const std::string& path) const
+    {
+        std::vector<SectionEntry> table;
+        std::uint64_t offset = align(sizeof(FileHeader) + sections_.size() * sizeof(SectionEntry));
+        for (const auto& s : sections_)
+        {
+            table.push_back({ s.id, s.count, offset, s.data.size(), crc32c::compute(s.data), 0 });
+            offset = align(offset + s.data.size());
+        }
+
+        FileHeader header{ SAVE_MAGIC, SAVE_VERSION, static_cast<std::uint16_t>(sections_.size()), 0, 0 };
+        header.table_crc = crc32c::compute(std::as_bytes(std::span(table)));
+        header.header_crc = crc32c::compute(std::as_bytes(std::span(&header, 1)));
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            throw GameError("セーブファイルを書き込めません: " + path);
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(SectionEntry)));
+        for (std::size_t i = 0; i < sections_.size(); ++i)
+        {
+            pad_to(out, table[i].offset);
+            out.write(reinterpret_cast<const char*>(sections_[i].data.data()), static_cast<std::streamsize>(sections_[i].data.size()));
+        }
+    }
+
+private:
+    struct Section
+    {
+        std::uint32_t          id;
+        std::uint32_t          count;
+        std::vector<std::byte> data;
+    };
+
+    static std::uint64_t align(std::uint64_t n)
+    {
+        return (n + SECTION_ALIGN - 1) / SECTION_ALIGN * SECTION_ALIGN;
+    }
+
+    static void pad_to(std::ofstream& out, std::uint64_t offset)
+    {
+        while (static_cast<std::uint64_t>(out.tellp()) < offset)
+        {
+            out.put('\0');
+        }
+    }
+
+    std::vector<Section> sections_;
+};
+
+// 読み込み専用で mmap した領域の持ち主（lesson27_4 の MappedFile を必要な分だけにしたもの）。
+// SaveLoader のコンストラクタが途中で例外を投げても、できあがったメンバとしてデストラクタが呼ばれ、解放される
+class ReadOnlyMapping
+{
+public:
+    explicit ReadOnlyMapping(const std::string& path)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            throw GameError("セーブファイルを開けませんでした: " + path);
+        }
+        struct stat st{};
+        if (::fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            throw GameError("セーブファイルの情報を取得できませんでした: " + path);
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ > 0)
+        {
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED)
+            {
+                ::close(fd);
+                throw GameError("セーブファイルをマップできませんでした: " + path);
+            }
+            data_ = static_cast<const std::byte*>(p);
+        }
+        ::close(fd);
+    }
+
+    ~ReadOnlyMapping()
+    {
+        if (data_ != nullptr)
+        {
+            ::munmap(const_cast<std::byte*>(data_), size_);
+        }
+    }
+
+    ReadOnlyMapping(const ReadOnlyMapping&) = delete;
+    ReadOnlyMapping& operator=(const ReadOnlyMapping&) = delete;
+
+    const std::byte* data() const { return data_; }
+    std::size_t      size() const { return size_; }
+
+private:
+    const std::byte* data_ = nullptr;
+    std::size_t      size_ = 0;
+};
+
+// --- 読み込み ---
+// ファイルを mmap し、各セクションの CRC 検証を別スレッドで並列に走らせる
+class SaveLoader
+{
+public:
+    explicit SaveLoader(const std::string& path) : path_(path), file_(path), data_(file_.data()), size_(file_.size())
+    {
+        if (size_ < sizeof(FileHeader))
+        {
+            throw SaveDataCorruptedError(path_, "header");
+        }
+        FileHeader header;
+        std::memcpy(&header, data_, sizeof(header));
+        const std::uint32_t stored_crc = header.header_crc;
+        header.header_crc = 0;
+        if (header.magic != SAVE_MAGIC || crc32c::compute(std::as_bytes(std::span(&header, 1))) != stored_crc)
+        {
+            throw SaveDataCorruptedError(path_, "header");
+        }
+        if (header.version > SAVE_VERSION)
+        {
+            throw GameError("新しいバージョンのセーブデータです (version " + std::to_string(header.version) + ")");
+        }
+        version_ = header.version;
+
+        const std::size_t table_bytes = header.section_count * sizeof(SectionEntry);
+        if (size_ < sizeof(FileHeader) + table_bytes)
+        {
+            throw SaveDataCorruptedError(path_, "section table");
+        }
+        table_.resize(header.section_count);
+        std::memcpy(table_.data(), data_ + sizeof(FileHeader), table_bytes);
+        if (crc32c::compute(std::as_bytes(std::span(table_))) != header.table_crc)
+        {
+            throw SaveDataCorruptedError(path_, "section table");
+        }
+
+        // 全セクションの検証を並列に開始する（ここでは待たない）
+        for (const auto& entry : table_)
+        {
+            // offset + size は桁あふれすることがあるので、足さずに比べる。
+            // 本体は SECTION_ALIGN 境界に置いているはずなので、ずれていれば壊れている
+            if (entry.offset > size_ || entry.size > size_ - entry.offset || entry.offset % SECTION_ALIGN != 0)
+            {
+                throw SaveDataCorruptedError(path_, name_of(entry.id));
+            }
+            const std::span<const std::byte> body(data_ + entry.offset, entry.size);
+            verified_.push_back(std::async(std::launch::async, [body, expected = entry.crc]()
+                {
+                    return crc32c::compute(body) == expected;
+                }));
+        }
+        ok_.resize(verified_.size(), false);
+    }
+
+    SaveLoader(const SaveLoader&) = delete;
+    SaveLoader& operator=(const SaveLoader&) = delete;
+
+    // 古いバージョンのファイルには無いセクションもあるので、使う前に確かめられるようにする
+    std::uint16_t version() const { return version_; }
+
+    bool has_section(const char (&id)[5]) const
+    {
+        return find(fourcc(id)) != nullptr;
+    }
+
+    // セクションをレコードの配列として返す。そのセクションの検証だけを待つ
+    template<typename T>
+    std::span<const T> section(const char (&id)[5])
+    {
+        const std::uint32_t key = fourcc(id);
+        const SectionEntry* entry = find(key);
+        if (entry == nullptr)
+        {
+            throw GameError("セクションがありません: " + name_of(key));
+        }
+        const std::size_t index = static_cast<std::size_t>(entry - table_.data());
+        if (!is_verified(index))
+        {
+            throw SaveDataCorruptedError(path_, name_of(key));
+        }
+        if (entry->size != entry->record_count * sizeof(T))
+        {
+            throw SaveDataCorruptedError(path_, name_of(key));
+        }
+        // セクションは SECTION_ALIGN 境界にそろっているので（コンストラクタで確かめている）、そのまま T の配列として読める
+        static_assert(alignof(T) <= SECTION_ALIGN);
+        if (entry->offset % alignof(T) != 0)
+        {
+            throw SaveDataCorruptedError(path_, name_of(key));
+        }
+        return { reinterpret_cast<const T*>(data_ + entry->offset), entry->record_count };
+    }
+
+private:
+    const SectionEntry* find(std::uint32_t id) const
+    {
+        for (const auto& e : table_)
+        {
+            if (e.id == id)
+            {
+                return &e;
+            }
+        }
+        return nullptr;
+    }
+
+    bool is_verified(std::size_t index)
+    {
+        if (verified_[index].valid())
+        {
+            ok_[index] = verified_[index].get(); // get() は1回しか呼べないので結果を覚えておく
+        }
+        return ok_[index];
+    }
+
+    static std::string name_of(std::uint32_t id)
+    {
+        return { static_cast<char>(id), static_cast<char>(id >> 8), static_cast<char>(id >> 16), static_cast<char>(id >> 24) };
+    }
+
+    std::string                     path_;
+    ReadOnlyMapping                 file_;      // verified_ より先に宣言する（検証中のスレッドが読み終えてから解放される）
+    const std::byte*                data_;
+    std::size_t                     size_;
+    std::uint16_t                   version_ = 0;
+    std::vector<SectionEntry>       table_;
+    std::vector<std::future<bool>>  verified_;
+    std::vector<bool>               ok_;
+};
+
+void write_sample_save(const std::string& path)
+{
+    PlayerRecord player{ "勇者", 85, 100, 12, 3600 };
+    std::vector<EntityRecord> entities;
+    for (std::uint32_t i = 0; i < 200000; ++i)
+    {
+        entities.push_back({ i, 30 + static_cast<std::int32_t>(i % 70), i * 0.5f, i * 0.25f,
+                             static_cast<std::uint16_t>(i % 3), 0 });
+    }
+    const std::uint32_t quests[] = { 101, 102, 205 };
+
+    SaveWriter writer;
+    writer.add_section("PLYR", std::span<const PlayerRecord>(&player, 1));
+    writer.add_section("ENTS", std::span<const EntityRecord>(entities));
+    writer.add_section("QUST", std::span<const std::uint32_t>(quests));
+    writer.write(path);
+}
+
+void load_and_play(const std::string& path)
+{
+    SaveLoader save(path);
+
+    // プレイヤーのセクションが検証できた時点でゲームを始められる
+    const PlayerRecord& player = save.section<PlayerRecord>("PLYR")[0];
+    std::cout << "プレイヤー: " << player.name << " Lv" << player.level
+              << " HP " << player.hp << "/" << player.max_hp << std::endl;
+
+    // 大きなセクションは、実際に使うときに検証結果を待つ
+    const auto entities = save.section<EntityRecord>("ENTS");
+    std::cout << "エンティティ: " << entities.size() << "体 (最後の id " << entities.back().id << ")" << std::endl;
+    if (save.has_section("QUST")) // version 2 で追加したセクション
+    {
+        std::cout << "クエスト: " << save.section<std::uint32_t>("QUST").size() << "件" << std::endl;
+    }
+}
+
+int main()
+{
+    const std::string path = "slot1.dat";
+    write_sample_save(path);
+
+    std::cout << "=== 正常なセーブデータ ===" << std::endl;
+    try
+    {
+        load_and_play(path);
+    }
+    catch (const GameError& e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+
+    // エンティティのセクションの途中を1バイト壊す
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(4096);
+        file.put('\x7F');
+    }
+
+    std::cout << "\n=== 壊れたセーブデータ ===" << std::endl;
+    try
+    {
+        load_and_play(path);
+    }
+    catch (const SaveDataCorruptedError& e)
+    {
+        // どのセクションが壊れているかがわかる
+        std::cerr << e.what() << std::endl;
+        std::cerr << "パス: " << e.save_path() << " / セクション: " << e.section() << std::endl;
+        std::cerr << "→ 新規ゲームで起動します" << std::endl;
+    }
+    catch (const GameError& e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+
+    std::remove(path.c_str());
+    return 0;
+}
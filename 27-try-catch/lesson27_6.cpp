@@ -0,0 +1,271 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// --- 例外を使わないエラー処理：std::expected（C++23） ---
+// lesson27_2 の get_enemy_name / divide と、lesson23_3 の Stack::pop は失敗すると例外を投げる。
+// 「インデックスが範囲外」や「スタックが空」がよく起きる処理では、
+// throw のたびにスタックの巻き戻しが走り、その1回がフレームの遅延のスパイクになる。
+//
+// std::expected<T, E> は「値 T か、エラー E のどちらか」を戻り値で返す。
+// ここでは本体をすべて expected で書き、例外を投げる版はその上の薄いラッパーにする。
+// 本体は -fno-exceptions でもコンパイルできる（ラッパーとベンチマークの throw 側だけが消える）
+//
+//   g++ -std=c++2b lesson27_6.cpp                  … 両方を比べる
+//   g++ -std=c++2b -fno-exceptions lesson27_6.cpp  … expected だけ
+//
+// ※ GCC 12 では <expected> を使うのに -std=c++2b が必要
+
+#if defined(__cpp_exceptions)
+#include <stdexcept>
+#define GAME_HAS_EXCEPTIONS 1
+#else
+#define GAME_HAS_EXCEPTIONS 0
+#endif
+
+// エラーの種類（文字列を組み立てないので、失敗してもヒープ確保が起きない）
+enum class GameErrc
+{
+    DivideByZero,
+    IndexOutOfRange,
+    StackEmpty,
+};
+
+constexpr std::string_view message_of(GameErrc e)
+{
+    switch (e)
+    {
+    case GameErrc::DivideByZero:    return "ゼロ除算はできません";
+    case GameErrc::IndexOutOfRange: return "インデックスが範囲外です";
+    case GameErrc::StackEmpty:      return "スタックが空です";
+    }
+    return "不明なエラー";
+}
+
+// --- expected を返す本体 ---
+std::expected<int, GameErrc> try_divide(int a, int b)
+{
+    if (b == 0)
+    {
+        return std::unexpected(GameErrc::DivideByZero);
+    }
+    return a / b;
+}
+
+// 名前は静的な表に置き、コピーせずに string_view で返す
+constexpr std::array<std::string_view, 3> ENEMY_NAMES = { "ゴブリン", "オーク", "ドラゴン" };
+
+std::expected<std::string_view, GameErrc> try_get_enemy_name(int index)
+{
+    if (index < 0 || index >= static_cast<int>(ENEMY_NAMES.size()))
+    {
+        return std::unexpected(GameErrc::IndexOutOfRange);
+    }
+    return ENEMY_NAMES[index];
+}
+
+// lesson23_3 の Stack に、例外を投げない try_pop / try_top を足したもの
+template<typename T>
+class Stack
+{
+public:
+    void push(const T& value)
+    {
+        items_.push_back(value);
+    }
+
+    // 取り出した値を返す（空なら StackEmpty）
+    std::expected<T, GameErrc> try_pop()
+    {
+        if (items_.empty())
+        {
+            return std::unexpected(GameErrc::StackEmpty);
+        }
+        T value = std::move(items_.back());
+        items_.pop_back();
+        return value;
+    }
+
+    std::expected<std::reference_wrapper<const T>, GameErrc> try_top() const
+    {
+        if (items_.empty())
+        {
+            return std::unexpected(GameErrc::StackEmpty);
+        }
+        return std::cref(items_.back());
+    }
+
+#if GAME_HAS_EXCEPTIONS
+    // 従来どおり例外を投げる版
+    void pop()
+    {
+        if (!try_pop())
+        {
+            throw std::underflow_error(std::string(message_of(GameErrc::StackEmpty)));
+        }
+    }
+
+    const T& top() const
+    {
+        auto result = try_top();
+        if (!result)
+        {
+            throw std::underflow_error(std::string(message_of(result.error())));
+        }
+        return result->get();
+    }
+#endif
+
+    bool empty() const { return items_.empty(); }
+    int  size()  const { return static_cast<int>(items_.size()); }
+
+private:
+    std::vector<T> items_;
+};
+
+#if GAME_HAS_EXCEPTIONS
+// --- lesson27_2 と同じ、例外を投げる版（expected の上のラッパー） ---
+int divide(int a, int b)
+{
+    auto result = try_divide(a, b);
+    if (!result)
+    {
+        throw std::invalid_argument(std::string(message_of(result.error())));
+    }
+    return *result;
+}
+
+std::string get_enemy_name(int index)
+{
+    auto result = try_get_enemy_name(index);
+    if (!result)
+    {
+        throw std::out_of_range(std::string(message_of(result.error())) + ": " + std::to_string(index));
+    }
+    return std::string(*result);
+}
+#endif
+
+// --- ベンチマーク：失敗する呼び出しの1回ごとの時間 ---
+using Clock = std::chrono::steady_clock;
+
+struct Latency
+{
+    double median_ns;
+    double p99_ns;
+    double max_ns;
+};
+
+template<typename F>
+Latency measure(int iterations, F&& call)
+{
+    std::vector<double> samples;
+    samples.reserve(iterations);
+    for (int i = 0; i < iterations; ++i)
+    {
+        const auto start = Clock::now();
+        call(i);
+        samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return { samples[samples.size() / 2], samples[samples.size() * 99 / 100], samples.back() };
+}
+
+void print_latency(const char* label, const Latency& l)
+{
+    std::cout << label << " 中央値 " << l.median_ns << "ns / p99 " << l.p99_ns
+              << "ns / 最大 " << l.max_ns << "ns" << std::endl;
+}
+
+int main()
+{
+    // --- 使い方：戻り値でエラーを確かめる ---
+    if (auto q = try_divide(10, 0); !q)
+    {
+        std::cerr << "[divide] " << message_of(q.error()) << std::endl;
+    }
+
+    for (int index : { 1, 99 })
+    {
+        auto name = try_get_enemy_name(index);
+        if (name)
+        {
+            std::cout << *name << std::endl;
+        }
+        else
+        {
+            std::cerr << "[get_enemy_name] " << message_of(name.error()) << ": " << index << std::endl;
+        }
+    }
+
+    // value_or で既定値に置き換えることもできる
+    std::cout << "名前: " << try_get_enemy_name(5).value_or("???") << std::endl;
+
+    Stack<std::string> action_history;
+    action_history.push("移動");
+    action_history.push("攻撃");
+    std::cout << "\n--- アクション履歴（undoシミュレーション）---" << std::endl;
+    while (auto action = action_history.try_pop())
+    {
+        std::cout << "取り消し: " << *action << std::endl;
+    }
+    std::cout << "もう一度 undo: " << message_of(action_history.try_pop().error()) << std::endl;
+
+    // --- 失敗する呼び出しの速さを比べる ---
+    constexpr int N = 200000;
+    volatile int sink = 0;
+    std::cout << "\n--- 範囲外の get_enemy_name を " << N << " 回 ---" << std::endl;
+
+    print_latency("expected:", measure(N, [&](int i)
+        {
+            auto name = try_get_enemy_name(100 + (i & 7));
+            sink = sink + (name ? 1 : 0);
+        }));
+
+#if GAME_HAS_EXCEPTIONS
+    print_latency("throw:   ", measure(N, [&](int i)
+        {
+            try
+            {
+                sink = sink + static_cast<int>(get_enemy_name(100 + (i & 7)).size());
+            }
+            catch (const std::out_of_range&)
+            {
+                sink = sink + 0;
+            }
+        }));
+#else
+    std::cout << "throw:    -fno-exceptions のため省略" << std::endl;
+#endif
+
+    std::cout << "\n--- 空の Stack::pop を " << N << " 回 ---" << std::endl;
+    Stack<int> empty_stack;
+    print_latency("expected:", measure(N, [&](int)
+        {
+            sink = sink + (empty_stack.try_pop() ? 1 : 0);
+        }));
+
+#if GAME_HAS_EXCEPTIONS
+    print_latency("throw:   ", measure(N, [&](int)
+        {
+            try
+            {
+                empty_stack.pop();
+            }
+            catch (const std::underflow_error&)
+            {
+                sink = sink + 0;
+            }
+        }));
+#endif
+
+    return 0;
+}